@@ -3,31 +3,28 @@
 #define AW2_ALPHA_WRAP_2_H
 
 #include "alpha_wrap_2/types.h"
-#include "alpha_wrap_2/point_set_oracle_2.h"
+#include "alpha_wrap_2/oracle.h"
 #include "alpha_wrap_2/export_utils.h"
 #include "alpha_wrap_2/statistics.h"
 #include "alpha_wrap_2/traversability.h"
 #include "alpha_wrap_2/timer.h"
+#include "alpha_wrap_2/gate_queue.h"
+#include "alpha_wrap_2/thread_pool.h"
 
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Delaunay_triangulation_2.h>
 
-#include <queue>
-#include <stack>
 #include <filesystem>
+#include <memory>
+#include <unordered_set>
+#include <variant>
 
 namespace aw2 {
     // Forward declaration
     class Timer;
 
     // type definitions
-    using Oracle = point_set_oracle_2;
-
-#ifdef USE_STACK_QUEUE
-        using Queue = std::stack<Gate>;
-#else
-    using Queue = std::priority_queue<Gate, std::vector<Gate>, std::less<> >;
-#endif
+    using Queue = std::variant<HeapGateQueue, StackGateQueue, BucketGateQueue, DaryGateQueue>;
 
     enum TraversabilityMethod {
         CONSTANT_ALPHA,
@@ -35,6 +32,29 @@ namespace aw2 {
         INTERSECTION_BASED
     };
 
+    enum QueueType {
+        // gates with the largest minimal Delaunay ball first
+        PRIORITY_QUEUE,
+        // last queued gate first
+        STACK_QUEUE,
+        // approximately largest minimal Delaunay ball first, bucketed by radius
+        BUCKET_QUEUE,
+        // same order as PRIORITY_QUEUE, 4-ary heap of compact entries
+        DARY_HEAP
+    };
+
+    enum QueueUpdateMode {
+        // rebuild the queue from all edges of the triangulation after each Steiner point insertion
+        FULL_RESCAN,
+        // only re-evaluate the gates in the conflict zone of the inserted Steiner point
+        INCREMENTAL
+    };
+
+    std::string queue_type_name(QueueType type);
+
+    // throws std::invalid_argument for unknown names
+    QueueType queue_type_from_name(const std::string &name);
+
     struct AlgorithmConfig {
         // algorithm parameters
         FT alpha = 10.0;
@@ -45,9 +65,44 @@ namespace aw2 {
         // Method-specific parameters
         TraversabilityParams traversability_params;
 
+        QueueUpdateMode queue_update_mode = FULL_RESCAN;
+
+#ifdef USE_STACK_QUEUE
+        QueueType queue_type = STACK_QUEUE;
+#else
+        QueueType queue_type = PRIORITY_QUEUE;
+#endif
+
+        // see the alternative traversability in doc/experiments.md
+#ifdef MODIFIED_ALPHA_TRAVERSABILITY
+        bool modified_alpha_traversability = true;
+#else
+        bool modified_alpha_traversability = false;
+#endif
+
+        // evaluate the traversability through the virtual interface instead of the statically dispatched
+        // policy, only useful as a benchmark baseline
+        bool dynamic_traversability = false;
+
+        // memoize the adaptive traversability per gate vertex pair, the result is the same
+        bool traversability_cache = true;
+
+        // threads used to evaluate gates when the queue is rebuilt, 0 uses all hardware threads
+        int n_threads = 1;
+
+        // Steiner points collected per round before they are inserted together, 1 inserts every point
+        // immediately. The points of a round have disjoint conflict zones and do not touch the faces of the
+        // gates processed after them.
+        int batch_insertion = 1;
+
+        // Gates popped per round whose rules are evaluated concurrently on the thread pool (--threads) before
+        // they are committed one by one in queue order, 1 processes one gate at a time. Cannot be combined
+        // with batch_insertion.
+        int speculative_gates = 1;
+
         int max_iterations = 5000;
 
-        // interval for exporting intermediate results
+        // interval for exporting intermediate results, 0 disables them
         int intermediate_steps = 50;
 
         // after this iteration we stop exporting intermediate results
@@ -58,9 +113,44 @@ namespace aw2 {
 
         // visualization style (default, clean, outside_filled)
         std::string style = "default";
+
+        // print the timing report and the number of iterations at the end of run()
+        bool print_report = true;
+
+        // export the final result and statistics.json to output_directory in run(), intermediate results are
+        // controlled by export_step_limit
+        bool export_results = true;
     };
 
 
+    // sets the fields of stats that describe config, the input file, the point order and the number of threads are
+    // left to the caller
+    void fill_config_stats(const AlgorithmConfig &config, ConfigStats &stats);
+
+    // config for an input whose bounding box diagonal is 1 / scale times that of the input config refers to, the
+    // relative parameters are multiplied by scale so that their absolute values stay the same
+    AlgorithmConfig rescaled_config(const AlgorithmConfig &config, FT scale);
+
+    // Compile-time configuration of the main loop, the variant of a run is selected once in init()
+    template<class TraversabilityT, bool ModifiedAlpha, class QueueT>
+    struct WrapPolicy {
+        using Traversability = TraversabilityT;
+        static constexpr bool modified_alpha_traversability = ModifiedAlpha;
+        using Queue = QueueT;
+    };
+
+    // Outcome of the rules for a gate, evaluated ahead of its commit
+    struct SpeculativeGate {
+        Gate gate;
+        // the rule was skipped because it already failed for the same faces
+        bool rule_1_known_negative = false;
+        bool rule_2_known_negative = false;
+        bool rule_1 = false;
+        bool rule_2 = false;
+        Point_2 steiner_point;
+        Rule2Query rule_2_query;
+    };
+
     struct EdgeAdjacencyInfo {
         Delaunay::Edge edge;
         Point_2 cc_inside;
@@ -86,7 +176,11 @@ namespace aw2 {
         FT offset_;
         AlgorithmConfig config_;
 
-        Traversability *traversability_;
+        std::unique_ptr<Traversability> traversability_;
+        TraversabilityCache traversability_cache_;
+
+        // only set if more than one thread is used
+        std::unique_ptr<ThreadPool> thread_pool_;
 
         FT bbox_diagonal_length_;
         Point_2 dt_bbox_min_;
@@ -95,7 +189,7 @@ namespace aw2 {
         std::vector<Segment_2> wrap_edges_;
 
         // exporter
-        alpha_wrap_2_exporter *exporter_;
+        std::unique_ptr<alpha_wrap_2_exporter> exporter_;
 
         // statistics tracking
         AlgorithmStatistics statistics_;
@@ -109,6 +203,8 @@ namespace aw2 {
         Timer *rule2_timer_ = nullptr;
         Timer *gate_processing_timer_ = nullptr;
         Timer *extraction_timer_ = nullptr;
+        // only set with speculative gate processing, the rule timers are not used then
+        Timer *speculation_timer_ = nullptr;
 
         // initialization and running
         alpha_wrap_2(const Oracle &oracle);
@@ -124,30 +220,113 @@ namespace aw2 {
 
         EdgeAdjacencyInfo gate_adjacency_info(const Delaunay::Edge &edge) const;
 
+        // re-locates the gate in the current triangulation, returns false if it is no longer a gate
+        bool refresh_gate(Gate &g) const;
+
     private:
         // gate and traversability processing methods
         static bool is_gate(const Delaunay::Edge &e);
 
+        // policy selection, sets the entry points below
+        template<class TraversabilityT>
+        void select_radius_policy();
+
+        template<class TraversabilityT, bool ModifiedAlpha>
+        void select_queue_policy();
+
+        template<class Policy>
+        void apply_policy();
+
+        template<class Policy>
+        void main_loop();
+
+        template<class Policy>
+        void main_loop_batched();
+
+        template<class Policy>
+        void main_loop_speculative();
+
+        // Rule 1 and Rule 2 for the gate without modifying the triangulation or the statistics, safe to call
+        // concurrently. Rule 2 is only evaluated if Rule 1 does not apply.
+        void evaluate_rules(SpeculativeGate &s) const;
+
+        void evaluate_rule_1(SpeculativeGate &s) const;
+
+        void evaluate_rule_2(SpeculativeGate &s) const;
+
+        // applies the evaluated rules of the gate committed as iteration_: counts them, remembers the negative
+        // outcomes in the inside face and exports the rule step. Returns true if s.steiner_point is to be inserted.
+        bool commit_rules(const SpeculativeGate &s);
+
+        template<class Policy>
+        typename Policy::Queue &queue();
+
+        // pops gates until a non-stale one is found, returns false if the queue ran empty
+        template<class Policy>
+        bool pop_gate(Gate &g);
+
+        template<class Policy>
         FT sq_minimal_delaunay_ball_radius(const Gate &gate) const;
 
-        // rule processing
-        bool process_rule_1(const Point_2 &c_in_cc, const Point_2 &c_out_cc);
+        // rule processing, return true and the Steiner point to insert if the rule applies
+        // negative outcomes are remembered in the inside face until one of the faces changes
+        bool process_rule_1(const Delaunay::Edge &gate_edge, const Point_2 &c_in_cc, const Point_2 &c_out_cc,
+                            Point_2 &steiner_point);
 
-        bool process_rule_2(const Delaunay::Face_handle &c_in, const Point_2 &c_in_cc);
+        bool process_rule_2(const Delaunay::Face_handle &c_in, const Point_2 &c_in_cc, Point_2 &steiner_point);
 
-        // update
-        void insert_steiner_point(const Point_2 &steiner_point);
+        // update, hint is a face at or next to the Steiner point and speeds up its location
+        template<class Policy>
+        void insert_steiner_point(const Point_2 &steiner_point, const Delaunay::Face_handle &hint);
 
+        // inserts the point and labels and caches the faces of its star, the queue is not touched
+        Delaunay::Vertex_handle insert_vertex(const Point_2 &steiner_point, const Delaunay::Face_handle &hint);
+
+        template<class Policy>
+        void repair_queue(const Delaunay::Vertex_handle &vh);
+
+        template<class Policy>
+        void rebuild_queue();
+
+        // fills g for the gate edge, returns true if it is traversable
+        template<class Policy>
+        bool evaluate_gate(const Delaunay::Edge &edge, Gate &g) const;
+
+        template<class Policy>
         void add_gate_to_queue(const Delaunay::Edge &edge);
 
+        template<class Policy>
         void update_queue(const Delaunay::Face_handle &fh);
 
         // utils
+        // stores circumcenter and squared circumradius in the face, has to be called for every new face
+        void cache_face_geometry(const Delaunay::Face_handle &f);
+
         Point_2 infinite_face_cc(const Delaunay::Face_handle &c_in, const Delaunay::Face_handle &c_out,
                                  int edge_index) const;
 
         void extract_wrap_surface();
 
+        // main loop and gate insertion instantiated for the configured policy
+        void (alpha_wrap_2::*main_loop_)() = nullptr;
+        void (alpha_wrap_2::*add_gate_to_queue_)(const Delaunay::Edge &) = nullptr;
+
+        // buffers of rebuild_queue
+        std::vector<Delaunay::Edge> rebuild_edges_;
+        std::vector<std::vector<Gate>> rebuild_gates_;
+
+        // buffers of main_loop_batched
+        std::vector<Point_2> batch_points_;
+        std::vector<Delaunay::Face_handle> batch_hints_;
+        std::vector<Delaunay::Face_handle> batch_conflicts_;
+        std::unordered_set<const void *> batch_touched_faces_;
+        SpeculativeGate batch_gate_;
+        std::vector<std::size_t> batch_order_;
+        std::vector<Delaunay::Vertex_handle> batch_vertices_;
+
+        // gates of the current round of main_loop_speculative
+        std::vector<SpeculativeGate> speculative_gates_;
+
         int max_iterations_ = 0;
         int iteration_ = 0;
         bool export_step_;
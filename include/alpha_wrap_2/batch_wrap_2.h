@@ -0,0 +1,50 @@
+// Public header for batch_wrap_2
+#ifndef AW2_BATCH_WRAP_2_H
+#define AW2_BATCH_WRAP_2_H
+
+#include "alpha_wrap_2/alpha_wrap_2.h"
+#include "alpha_wrap_2/point_order.h"
+#include "alpha_wrap_2/statistics.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace aw2 {
+    // Input files listed by a manifest, which is either a directory (its .pts files), a .json file with an array
+    // of paths (relative to the directory of the manifest) or a glob pattern. Directories and patterns are sorted
+    // by name, a JSON list keeps its order. Throws std::invalid_argument if the manifest cannot be read or lists
+    // no files.
+    std::vector<std::string> read_manifest(const std::string &manifest);
+
+    struct BatchConfig {
+        PointOrder point_order = FILE_ORDER;
+        // build the local geometry field for every file
+        bool local_field = false;
+        // memory budget of the oracle, shared by the concurrent wraps, 0 is unbounded
+        std::size_t memory_budget = OracleParams{}.memory_budget;
+        bool verify = false;
+        // files wrapped concurrently, 0 uses all hardware threads
+        int n_threads = 0;
+    };
+
+    // Wraps many small inputs in one process. Every file is read, gets its own oracle and is wrapped by a
+    // single-threaded alpha_wrap_2 with the relative parameters of config, on a pool of batch.n_threads threads
+    // taking the largest files first. A file that fails is recorded with its error and does not stop the batch.
+    class batch_wrap_2 {
+    public:
+        // Every file is exported to its own subdirectory of config.output_directory named after the file (with
+        // the manifest index appended if names collide): the final result, statistics.json and wrap_edges.txt.
+        // batch_summary.json in config.output_directory holds the throughput and the per-file latencies.
+        void run(const std::vector<std::string> &files, const AlgorithmConfig &config, const BatchConfig &batch);
+
+        const BatchStatistics &get_statistics() const { return statistics_; }
+
+        BatchStatistics statistics_;
+
+    private:
+        void wrap_file(BatchFileStats &file, const AlgorithmConfig &config, const BatchConfig &batch) const;
+    };
+}
+
+#endif // AW2_BATCH_WRAP_2_H
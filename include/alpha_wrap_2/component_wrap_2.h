@@ -0,0 +1,61 @@
+// Public header for component_wrap_2
+#ifndef AW2_COMPONENT_WRAP_2_H
+#define AW2_COMPONENT_WRAP_2_H
+
+#include "alpha_wrap_2/alpha_wrap_2.h"
+#include "alpha_wrap_2/oracle.h"
+#include "alpha_wrap_2/reachability_grid.h"
+#include "alpha_wrap_2/statistics.h"
+#include "alpha_wrap_2/types.h"
+
+#include <vector>
+
+namespace aw2 {
+    // Groups the input points such that points at most distance apart are in the same group, with a union-find
+    // over grid cells whose diagonal is distance. Neighboring cells with many points are joined without testing
+    // their points, so a group may contain points further apart, joining is always safe. Largest group first.
+    // Throws std::invalid_argument for a non-positive distance.
+    std::vector<Points> offset_connected_components(const point_set_oracle_2 &oracle, FT distance);
+
+    // Wraps the offset-connected components of the input separately. Points of different components are more
+    // than 2 * (alpha + offset) apart, which leaves room for a ball of radius alpha between their offset
+    // surfaces, so a monolithic run separates them as well unless the ball cannot reach the gap. Components
+    // enclosed by others are recognized with a flood fill of the whole input and not wrapped at all in a
+    // monolithic run, their edges are dropped.
+    class component_wrap_2 {
+    public:
+        explicit component_wrap_2(const Oracle &oracle);
+
+        // config is relative to the bounding box of the whole input like for alpha_wrap_2, params are the absolute
+        // oracle parameters. The components are wrapped concurrently on config.n_threads threads (0 uses all
+        // hardware threads) and share the memory budget, with local_field every component builds its local geometry
+        // field. The merged edges and the statistics are exported to output_directory.
+        void run(const AlgorithmConfig &config, const OracleParams &params, bool local_field = false);
+
+        const ComponentWrapStatistics &get_statistics() const { return statistics_; }
+
+        // wrap edges of all components, like alpha_wrap_2::wrap_edges_
+        std::vector<Segment_2> wrap_edges_;
+
+        ComponentWrapStatistics statistics_;
+
+    private:
+        struct Component {
+            Points points;
+            std::vector<Segment_2> edges;
+            ComponentStats stats;
+        };
+
+        void wrap_component(Component &component, const AlgorithmConfig &config, const OracleParams &params) const;
+
+        const Oracle &oracle_;
+
+        // set by run()
+        bool local_field_ = false;
+
+        // cells of half of alpha + offset of the whole input, empty if it does not fit into the memory budget
+        ReachabilityGrid reachability_;
+    };
+}
+
+#endif // AW2_COMPONENT_WRAP_2_H
@@ -0,0 +1,105 @@
+// Public header for distance_field_oracle_2
+#ifndef AW2_DISTANCE_FIELD_ORACLE_2_H
+#define AW2_DISTANCE_FIELD_ORACLE_2_H
+
+#include "alpha_wrap_2/types.h"
+#include "alpha_wrap_2/point_set_oracle_2.h"
+
+#include <atomic>
+#include <limits>
+#include <vector>
+
+namespace aw2 {
+    struct DistanceFieldStats {
+        FT resolution = 0.0;
+        std::size_t n_tiles = 0;
+        std::size_t n_allocated_tiles = 0;
+        std::size_t memory_bytes = 0;
+        // queries compared against the exact oracle in verify mode, and how many of them disagreed
+        std::size_t n_verified = 0;
+        std::size_t n_mismatches = 0;
+    };
+
+    // Oracle answering the offset surface queries from a precomputed unsigned distance field.
+    // The field is sampled on a lattice with spacing tied to the offset and stored sparsely in tiles: only tiles
+    // near the offset surface hold samples, all others only a lower bound on the distance to the input.
+    // first_intersection sphere-traces the segment through the field and resolves the crossing with the exact
+    // kd-tree queries of the base class on a short window, outside_offset only computes the exact distance close
+    // to the offset surface. All other queries, squared_distance included, are inherited from the base class.
+    class distance_field_oracle_2 : public point_set_oracle_2 {
+    public:
+        // the points whose side the field cannot decide are answered with one batched exact query
+        void outside_offset(const std::vector<Point_2> &points, FT offset_size, std::vector<bool> &outside) const;
+
+        bool first_intersection(const Point_2 &p,
+                                const Point_2 &q,
+                                Point_2 &o,
+                                FT offset_size,
+                                FT &lambda) const;
+
+        bool first_intersection(const Point_2 &p, const Point_2 &q,
+                                Point_2 &o,
+                                FT offset_size) const;
+
+        // rasterizes the field for params.offset within params.memory_budget, leaves it empty (all queries exact)
+        // if not even a single tile fits
+        void prepare(const OracleParams &params);
+
+        DistanceFieldStats field_stats() const;
+
+    private:
+        static constexpr int tile_size = 16;
+        static constexpr std::size_t no_samples = std::numeric_limits<std::size_t>::max();
+
+        struct Tile {
+            // lower bound on the distance to the input anywhere in the tile
+            float lower_bound;
+            // index of the first of the (tile_size + 1)^2 samples, or no_samples
+            std::size_t first_sample;
+        };
+
+        bool has_field() const { return !tiles_.empty(); }
+
+        // lays out the tiles for the given spacing and computes their lower bounds,
+        // returns the memory needed for the samples
+        std::size_t layout(FT resolution);
+
+        void rasterize();
+
+        // Lower bound on the distance to the input at p. If the sample tile containing p is allocated,
+        // approx is set to the interpolated distance, which is accurate within error_.
+        FT lower_bound(const Point_2 &p, FT &approx, bool &sampled) const;
+
+        // side of the offset surface from the field alone, returns false if p is too close to the surface
+        bool field_outside_offset(const Point_2 &p, bool &outside) const;
+
+        bool field_first_intersection(const Point_2 &p, const Point_2 &q, Point_2 &o, FT offset_size,
+                                      FT &lambda) const;
+
+        void count_verified(bool mismatch) const;
+
+        FT offset_ = 0.0;
+        bool verify_ = false;
+
+        FT x0_ = 0.0;
+        FT y0_ = 0.0;
+        FT resolution_ = 0.0;
+        FT inv_resolution_ = 0.0;
+        // maximum deviation of an interpolated sample from the true distance
+        FT error_ = 0.0;
+        // tiles with a lower bound above offset_ + band_ are not sampled
+        FT band_ = 0.0;
+        // bounding box of the input points
+        FT x_min_ = 0.0, x_max_ = 0.0, y_min_ = 0.0, y_max_ = 0.0;
+        int n_tiles_x_ = 0;
+        int n_tiles_y_ = 0;
+
+        std::vector<Tile> tiles_;
+        std::vector<float> samples_;
+
+        mutable std::atomic<std::size_t> n_verified_{0};
+        mutable std::atomic<std::size_t> n_mismatches_{0};
+    };
+}
+
+#endif // AW2_DISTANCE_FIELD_ORACLE_2_H
@@ -3,7 +3,7 @@
 #define AW2_EXPORT_UTILS_H
 
 #include "alpha_wrap_2/types.h"
-#include "alpha_wrap_2/point_set_oracle_2.h"
+#include "alpha_wrap_2/oracle.h"
 #include <fstream>
 #include <limits>
 #include <iomanip>
@@ -13,8 +13,6 @@
 namespace fs = std::filesystem;
 
 namespace aw2 {
-    using Oracle = point_set_oracle_2;
-
     // Forward declaration
     class alpha_wrap_2;
     struct Gate;
@@ -264,6 +262,9 @@ namespace aw2 {
         mutable std::mt19937 inside_rng_;
         mutable std::mt19937 outside_rng_;
     };
+
+    // Writes one edge per line as "x1 y1 x2 y2", for results assembled from several wraps
+    void export_wrap_edges(const std::vector<Segment_2> &edges, const std::string &filepath);
 }
 
 
@@ -0,0 +1,158 @@
+#ifndef AW2_GATE_QUEUE_H
+#define AW2_GATE_QUEUE_H
+
+#include "alpha_wrap_2/types.h"
+#include "alpha_wrap_2/traversability.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <stack>
+#include <unordered_set>
+#include <vector>
+
+namespace aw2 {
+    struct GateKeyHash {
+        std::size_t operator()(const GateKey &k) const;
+    };
+
+    // Approximate largest-first order: gates are bucketed by the exponent and the two leading mantissa bits
+    // of sq_min_delaunay_rad (radii within a bucket differ by less than a factor 1.25) and returned
+    // last-in first-out within a bucket. Push and pop are constant time, a bitmap finds the next
+    // non-empty bucket.
+    class BucketGateContainer {
+    public:
+        void push(const Gate &g) {
+            const auto b = bucket(g.sq_min_delaunay_rad);
+            buckets_[b].push_back(g);
+            occupied_[b / 64] |= std::uint64_t(1) << (b % 64);
+            if (b > top_ || size_ == 0) top_ = b;
+            ++size_;
+        }
+
+        const Gate &top() const { return buckets_[top_].back(); }
+
+        void pop();
+
+        bool empty() const { return size_ == 0; }
+
+        std::size_t size() const { return size_; }
+
+        // keeps the capacity of the buckets
+        void clear();
+
+    private:
+        static constexpr std::size_t n_buckets = std::size_t(1) << 13;
+
+        static std::size_t bucket(const FT sq_radius) {
+            // for non-negative doubles the bit pattern is monotone in the value
+            std::uint64_t bits;
+            std::memcpy(&bits, &sq_radius, sizeof(bits));
+            return sq_radius > 0 ? static_cast<std::size_t>(bits >> 50) & (n_buckets - 1) : 0;
+        }
+
+        std::vector<std::vector<Gate> > buckets_ = std::vector<std::vector<Gate> >(n_buckets);
+        std::array<std::uint64_t, n_buckets / 64> occupied_{};
+        std::size_t top_ = 0;
+        std::size_t size_ = 0;
+    };
+
+    // 4-ary max-heap on sq_min_delaunay_rad. The heap only moves 16 byte entries (key and pool slot),
+    // the gates stay in a pool, so sifting touches fewer cache lines than a heap of gates.
+    class DaryGateHeap {
+    public:
+        void push(const Gate &g);
+
+        const Gate &top() const { return pool_[heap_.front().slot]; }
+
+        void pop();
+
+        bool empty() const { return heap_.empty(); }
+
+        std::size_t size() const { return heap_.size(); }
+
+        void clear() {
+            heap_.clear();
+            pool_.clear();
+            free_slots_.clear();
+        }
+
+    private:
+        struct Entry {
+            FT key;
+            std::uint32_t slot;
+        };
+
+        static_assert(sizeof(Entry) == 16, "heap entries should stay compact");
+
+        void sift_up(std::size_t i);
+
+        void sift_down(std::size_t i);
+
+        std::vector<Entry> heap_;
+        std::vector<Gate> pool_;
+        std::vector<std::uint32_t> free_slots_;
+    };
+
+    namespace detail {
+        template<class Container>
+        void clear_container(Container &c) {
+            Container empty;
+            std::swap(c, empty);
+        }
+
+        inline void clear_container(BucketGateContainer &c) { c.clear(); }
+
+        inline void clear_container(DaryGateHeap &c) { c.clear(); }
+    }
+
+    // Queue of traversable gates, the order in which gates are returned is given by the Container.
+    // Entries are never removed when the triangulation changes. Entries whose adjacent faces were destroyed
+    // or relabelled become stale and have to be dropped by the caller when they reach the top.
+    // Pushing a gate which is already queued (same vertices and adjacent faces) is a no-op.
+    template<class Container>
+    class GateQueue {
+    public:
+        // returns false if the gate was already queued
+        bool push(const Gate &g) {
+            if (!keys_.insert(g.key).second) {
+                return false;
+            }
+            gates_.push(g);
+            return true;
+        }
+
+        const Gate &top() const { return gates_.top(); }
+
+        void pop() {
+            keys_.erase(gates_.top().key);
+            gates_.pop();
+        }
+
+        bool empty() const { return gates_.empty(); }
+
+        std::size_t size() const { return gates_.size(); }
+
+        void clear() {
+            detail::clear_container(gates_);
+            keys_.clear();
+        }
+
+    private:
+        Container gates_;
+        std::unordered_set<GateKey, GateKeyHash> keys_;
+    };
+
+    // gate with the largest minimal Delaunay ball radius first
+    using HeapGateQueue = GateQueue<std::priority_queue<Gate, std::vector<Gate>, std::less<> > >;
+
+    // most recently pushed gate first
+    using StackGateQueue = GateQueue<std::stack<Gate> >;
+
+    using BucketGateQueue = GateQueue<BucketGateContainer>;
+
+    using DaryGateQueue = GateQueue<DaryGateHeap>;
+}
+
+#endif // AW2_GATE_QUEUE_H
@@ -0,0 +1,82 @@
+// Public header for grid_oracle_2
+#ifndef AW2_GRID_ORACLE_2_H
+#define AW2_GRID_ORACLE_2_H
+
+#include "alpha_wrap_2/types.h"
+#include "alpha_wrap_2/point_set_oracle_2.h"
+
+#include <vector>
+
+namespace aw2 {
+    // Oracle backed by a uniform grid. The points are sorted by cell and stored contiguously, so the fixed-radius
+    // queries of the algorithm become a few cell lookups. The kd-tree of the base class is kept for
+    // everything not answered by the grid and as a fallback before prepare() was called.
+    class grid_oracle_2 : public point_set_oracle_2 {
+    public:
+        bool do_intersect(const K::Triangle_2 &t) const;
+
+        bool do_intersect(const K::Triangle_2 &t, std::size_t &n_visited) const;
+
+        bool rule_2_query(const K::Triangle_2 &t, const Point_2 &c, FT offset_size, Rule2Query &result) const;
+
+        FT squared_distance(const Point_2 &p) const;
+
+        Point_2 closest_point(const Point_2 &p) const;
+
+        void squared_distances(const std::vector<Point_2> &points, std::vector<FT> &sq_distances) const;
+
+        void outside_offset(const std::vector<Point_2> &points, FT offset_size, std::vector<bool> &outside) const;
+
+        bool first_intersection(const Point_2 &p,
+                                const Point_2 &q,
+                                Point_2 &o,
+                                FT offset_size,
+                                FT &lambda) const;
+
+        bool first_intersection(const Point_2 &p, const Point_2 &q,
+                                Point_2 &o,
+                                FT offset_size) const;
+
+        Points local_points(const Segment_2 &seg, FT margin) const;
+
+        void points_near_segment(const Segment_2 &seg, FT distance, std::vector<FT> &xs, std::vector<FT> &ys) const;
+
+        // builds the grid, the cell size is derived from alpha and offset
+        void prepare(const OracleParams &params);
+
+        FT cell_size() const { return cell_size_; }
+
+    private:
+        void build(FT cell_size);
+
+        // ring search for the closest point, starting from a known candidate at squared distance best_sq_dist
+        Point_2 closest_point(const Point_2 &p, FT best_sq_dist, Point_2 best) const;
+
+        bool has_grid() const { return !cell_start_.empty(); }
+
+        int cell_x(FT x) const;
+
+        int cell_y(FT y) const;
+
+        std::size_t cell_index(const int ix, const int iy) const {
+            return static_cast<std::size_t>(iy) * nx_ + ix;
+        }
+
+        FT x0_ = 0.0;
+        FT y0_ = 0.0;
+        FT cell_size_ = 0.0;
+        FT inv_cell_size_ = 0.0;
+        int nx_ = 0;
+        int ny_ = 0;
+
+        Point_2 cell_point(const std::size_t i) const { return Point_2(cell_xs_[i], cell_ys_[i]); }
+
+        // coordinates of the points of cell c are stored at cell_start_[c] ... cell_start_[c + 1] - 1,
+        // in structure-of-arrays layout for the batched intersection kernel
+        std::vector<std::size_t> cell_start_;
+        std::vector<FT> cell_xs_;
+        std::vector<FT> cell_ys_;
+    };
+}
+
+#endif // AW2_GRID_ORACLE_2_H
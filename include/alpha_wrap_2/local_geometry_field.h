@@ -0,0 +1,92 @@
+// Public header for local_geometry_field
+#ifndef AW2_LOCAL_GEOMETRY_FIELD_H
+#define AW2_LOCAL_GEOMETRY_FIELD_H
+
+#include "alpha_wrap_2/types.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace aw2 {
+    struct LocalGeometryFieldStats {
+        FT resolution = 0.0;
+        std::size_t n_cells = 0;
+        std::size_t memory_bytes = 0;
+        double build_time_ms = 0.0;
+    };
+
+    // Bounds on the input points inside a closed box and their summed squared distance to a segment
+    struct BoxDeviationBounds {
+        std::size_t n_lower = 0;
+        std::size_t n_upper = 0;
+        FT sum_lower = 0.0;
+        FT sum_upper = 0.0;
+    };
+
+    // Precomputed local statistics of the input on a uniform grid: prefix sums of the point count, the
+    // coordinates and their products per cell, and the chessboard distance (in cells) to the nearest occupied
+    // cell as a clearance estimate. Answers bound queries in constant time, used by the adaptive
+    // traversability criteria to decide most gates without exact oracle queries.
+    class LocalGeometryField {
+    public:
+        // Builds the field for the points (xs[i], ys[i]). The cell size starts at a quarter of the offset and is
+        // doubled until the field fits into memory_budget bytes (0 means unlimited), the field stays empty if not
+        // even a single cell fits.
+        void build(const std::vector<FT> &xs, const std::vector<FT> &ys, FT offset, std::size_t memory_budget);
+
+        bool empty() const { return prefix_.empty(); }
+
+        // lower bound on the distance from (x, y) to the nearest input point
+        FT distance_lower_bound(FT x, FT y) const;
+
+        // Bounds on the number of input points in the closed box [xmin, xmax] x [ymin, ymax] and on the sum of
+        // their squared distances to the segment (ax, ay) - (bx, by)
+        BoxDeviationBounds box_deviation_bounds(FT ax, FT ay, FT bx, FT by,
+                                                FT xmin, FT xmax, FT ymin, FT ymax) const;
+
+        const LocalGeometryFieldStats &stats() const { return stats_; }
+
+    private:
+        // count, sum of x, y, x^2, xy, y^2 with coordinates relative to (x0_, y0_)
+        struct Moments {
+            FT n, x, y, xx, xy, yy;
+        };
+
+        static constexpr std::uint8_t max_ring = 255;
+
+        int cell_x(FT x) const;
+
+        int cell_y(FT y) const;
+
+        // sums of the moments over the cells [ix0, ix1] x [iy0, iy1] (empty if ix0 > ix1 or iy0 > iy1),
+        // scale is set to the sum of the absolute values involved, a measure of the rounding error
+        Moments cell_range_moments(int ix0, int ix1, int iy0, int iy1, Moments &scale) const;
+
+        std::size_t cell_range_count(int ix0, int ix1, int iy0, int iy1) const;
+
+        // upper bound on the points in the closed box, by the cells the box overlaps
+        std::size_t box_count_upper(FT xmin, FT xmax, FT ymin, FT ymax) const;
+
+        const Moments &prefix(const int ix, const int iy) const {
+            return prefix_[static_cast<std::size_t>(iy) * (nx_ + 1) + ix];
+        }
+
+        FT x0_ = 0.0;
+        FT y0_ = 0.0;
+        FT x1_ = 0.0;
+        FT y1_ = 0.0;
+        FT cell_size_ = 0.0;
+        FT inv_cell_size_ = 0.0;
+        int nx_ = 0;
+        int ny_ = 0;
+
+        // (nx_ + 1) x (ny_ + 1) prefix sums, prefix(ix, iy) covers the cells [0, ix) x [0, iy)
+        std::vector<Moments> prefix_;
+        // chessboard distance to the nearest occupied cell, saturated at max_ring
+        std::vector<std::uint8_t> ring_;
+
+        LocalGeometryFieldStats stats_;
+    };
+}
+
+#endif // AW2_LOCAL_GEOMETRY_FIELD_H
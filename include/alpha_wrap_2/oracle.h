@@ -0,0 +1,23 @@
+// Selects the oracle implementation used by the algorithm
+#ifndef AW2_ORACLE_H
+#define AW2_ORACLE_H
+
+#include "alpha_wrap_2/point_set_oracle_2.h"
+#include "alpha_wrap_2/grid_oracle_2.h"
+#include "alpha_wrap_2/distance_field_oracle_2.h"
+
+namespace aw2 {
+    // An oracle has to provide do_intersect, rule_2_query, squared_distance(s), outside_offset, closest_point,
+    // first_intersection, local_points and points_near_segment, as well as prepare(), the local geometry field and
+    // the point access used for exporting and statistics (see point_set_oracle_2). The backend is chosen with the
+    // ORACLE_BACKEND CMake option.
+#if defined(ORACLE_BACKEND_GRID)
+    using Oracle = grid_oracle_2;
+#elif defined(ORACLE_BACKEND_DISTANCE_FIELD)
+    using Oracle = distance_field_oracle_2;
+#else
+    using Oracle = point_set_oracle_2;
+#endif
+}
+
+#endif // AW2_ORACLE_H
@@ -0,0 +1,30 @@
+// Public header for point_order
+#ifndef AW2_POINT_ORDER_H
+#define AW2_POINT_ORDER_H
+
+#include "alpha_wrap_2/types.h"
+
+#include <string>
+
+namespace aw2 {
+    enum PointOrder {
+        // keep the order of the input file
+        FILE_ORDER,
+        // Z-order curve, cheapest key
+        MORTON_ORDER,
+        // Hilbert curve, consecutive points are always neighbors on the curve
+        HILBERT_ORDER
+    };
+
+    std::string point_order_name(PointOrder order);
+
+    // throws std::invalid_argument for unknown names
+    PointOrder point_order_from_name(const std::string &name);
+
+    // Sorts the points along a space-filling curve over their bounding box, so that points close in the plane
+    // are close in memory. Keys are computed and sorted in parallel for large inputs, n_threads == 0 uses all
+    // hardware threads. The order of points with equal keys is kept.
+    void reorder_points(Points &points, PointOrder order, unsigned n_threads = 1);
+}
+
+#endif // AW2_POINT_ORDER_H
@@ -3,12 +3,12 @@
 #define AW2_POINT_SET_ORACLE_2_H
 
 #include "alpha_wrap_2/types.h"
+#include "alpha_wrap_2/local_geometry_field.h"
 
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Kd_tree.h>
 #include <CGAL/Search_traits_2.h>
 #include <CGAL/Orthogonal_k_neighbor_search.h>
-#include <CGAL/Orthogonal_incremental_neighbor_search.h>
 #include <CGAL/Fuzzy_iso_box.h>
 #include <CGAL/Polygon_2_algorithms.h>
 #include <CGAL/Exact_circular_kernel_2.h>
@@ -21,13 +21,35 @@ namespace aw2 {
         FT y_max = -std::numeric_limits<FT>::infinity();
     };
 
+    // Absolute algorithm parameters, oracles may use them to set up acceleration structures
+    struct OracleParams {
+        FT alpha = 0.0;
+        FT offset = 0.0;
+        // upper bound in bytes for precomputed data (distance field oracle, local geometry field), 0 means unlimited
+        std::size_t memory_budget = std::size_t(256) << 20;
+        // compare approximate answers against the exact queries (distance field oracle)
+        bool verify = false;
+    };
+
+    // Result of the fused Rule 2 query for a face with circumcenter c
+    struct Rule2Query {
+        // an input point lies strictly inside the face
+        bool occupied = false;
+        // input point closest to c, only set if occupied
+        Point_2 projection;
+        // first intersection of the segment (c, projection) with the offset surface
+        bool intersects = false;
+        Point_2 steiner_point;
+        // number of input points touched by the query
+        std::size_t n_visited = 0;
+    };
+
     class point_set_oracle_2 {
     protected:
         using Traits = CGAL::Search_traits_2<K>;
         using Tree = CGAL::Kd_tree<Traits>;
         using BBox = bbox_2;
         typedef CGAL::Orthogonal_k_neighbor_search<Traits> Neighbor_search;
-        typedef CGAL::Orthogonal_incremental_neighbor_search<Traits> Incremental_neighbor_search;
 
     public:
         bool empty() const;
@@ -38,10 +60,25 @@ namespace aw2 {
 
         bool do_intersect(const K::Triangle_2 &t) const;
 
+        // same as above, n_visited is set to the number of points tested against the triangle
+        bool do_intersect(const K::Triangle_2 &t, std::size_t &n_visited) const;
+
+        // Answers do_intersect(t), closest_point(c) and first_intersection(c, closest_point(c), offset_size)
+        // with a single traversal, c is the circumcenter of t. Returns result.occupied.
+        bool rule_2_query(const K::Triangle_2 &t, const Point_2 &c, FT offset_size, Rule2Query &result) const;
+
         FT squared_distance(const Point_2 &p) const;
 
         Point_2 closest_point(const Point_2 &p) const;
 
+        // squared_distance of every point in one pass, the nearest point of the previous query bounds the next
+        // search. Intended for sequences of nearby points such as the samples along a gate.
+        void squared_distances(const std::vector<Point_2> &points, std::vector<FT> &sq_distances) const;
+
+        // for every point whether it lies on or outside the offset surface, i.e. its squared_distance is at least
+        // offset_size^2. Only the side is defined, oracles may decide it without computing the distance.
+        void outside_offset(const std::vector<Point_2> &points, FT offset_size, std::vector<bool> &outside) const;
+
         bool first_intersection(const Point_2 &p,
                                 const Point_2 &q,
                                 Point_2 &o,
@@ -57,10 +94,33 @@ namespace aw2 {
 
         void load_points(const std::string &filename);
 
+        // reads the points of a file in the format of load_points without adding them
+        static Points read_points(const std::string &filename);
+
+        // called once after all points are added and before the first query
+        void prepare(const OracleParams &params);
+
+        // optional preprocessing for the adaptive traversability, called after prepare()
+        void build_local_geometry_field(const OracleParams &params);
+
+        // empty unless build_local_geometry_field() was called
+        const LocalGeometryField &local_geometry_field() const { return local_field_; }
+
+        FT bbox_diagonal_length() const;
+
+        std::size_t size() const;
+
         Points local_points(const Segment_2 &seg, FT margin) const;
 
+        // Replaces xs and ys with the coordinates of all input points within the given distance of seg, plus
+        // possibly some further away (the query region is a strip around seg clipped to its grown bounding box)
+        void points_near_segment(const Segment_2 &seg, FT distance, std::vector<FT> &xs, std::vector<FT> &ys) const;
+
         Tree tree_;
         BBox bbox_;
+
+    private:
+        LocalGeometryField local_field_;
     };
 }
 
@@ -0,0 +1,48 @@
+// Public header for reachability_grid
+#ifndef AW2_REACHABILITY_GRID_H
+#define AW2_REACHABILITY_GRID_H
+
+#include "alpha_wrap_2/point_set_oracle_2.h"
+#include "alpha_wrap_2/types.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace aw2 {
+    // Coarse approximation of the region a wrap can reach from the outside: a 4-connected flood fill from the
+    // border over the grid cells without input points. The cell containing the center of a ball of radius alpha
+    // that keeps the offset distance to the input is free for cells of half the size of alpha + offset, so every
+    // region the wrap reaches is connected to the border through free cells. Used by the drivers that wrap parts
+    // of the input separately to recognize wraps of regions enclosed by the rest of the input.
+    class ReachabilityGrid {
+    public:
+        enum CellState : std::uint8_t { FREE, OCCUPIED, REACHED };
+
+        // Builds the grid over the bounding box of the input with a margin of one cell. Returns false and leaves
+        // the grid empty if it needs more than memory_budget bytes (0 means unlimited).
+        bool build(const point_set_oracle_2 &oracle, FT cell_size, std::size_t memory_budget);
+
+        bool empty() const { return cells_.empty(); }
+
+        // 0 for an empty grid
+        FT cell_size() const { return cell_size_; }
+
+        // state of the cell containing p, points outside of the grid are reached
+        CellState state(const Point_2 &p) const;
+
+        // Whether the OUTSIDE faces of a wrap lie in an enclosed region: one of their centroids is in a free cell
+        // that was not reached and none in a reached cell. Undecided (false) without faces in free cells or for an
+        // empty grid.
+        bool is_enclosed(const Delaunay &dt) const;
+
+    private:
+        std::vector<CellState> cells_;
+        FT x0_ = 0.0;
+        FT y0_ = 0.0;
+        FT cell_size_ = 0.0;
+        int nx_ = 0;
+        int ny_ = 0;
+    };
+}
+
+#endif // AW2_REACHABILITY_GRID_H
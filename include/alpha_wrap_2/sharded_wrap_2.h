@@ -0,0 +1,63 @@
+// Public header for sharded_wrap_2
+#ifndef AW2_SHARDED_WRAP_2_H
+#define AW2_SHARDED_WRAP_2_H
+
+#include "alpha_wrap_2/alpha_wrap_2.h"
+#include "alpha_wrap_2/oracle.h"
+#include "alpha_wrap_2/statistics.h"
+#include "alpha_wrap_2/tiled_wrap_2.h"
+#include "alpha_wrap_2/types.h"
+
+#include <cstddef>
+
+namespace aw2 {
+    // Copy of the input points in an anonymous shared memory mapping, which forked processes use without copying.
+    // Throws std::runtime_error if the mapping fails.
+    class SharedPoints {
+    public:
+        explicit SharedPoints(const Points &points);
+
+        ~SharedPoints();
+
+        SharedPoints(const SharedPoints &) = delete;
+
+        SharedPoints &operator=(const SharedPoints &) = delete;
+
+        const Point_2 *begin() const { return data_; }
+
+        const Point_2 *end() const { return data_ + size_; }
+
+        std::size_t size() const { return size_; }
+
+    private:
+        Point_2 *data_ = nullptr;
+        std::size_t size_ = 0;
+        std::size_t n_bytes_ = 0;
+    };
+
+    // Wraps the tiles of a tiled_wrap_2 in forked worker processes instead of threads, so a run does not depend on
+    // the thread safety of the library. The tiles are distributed to the workers by their point count, every
+    // worker collects the points of its tiles from the shared mapping and wraps them one after the other. The
+    // edges and statistics of each tile are sent back through a pipe as soon as the tile is done, the parent
+    // stitches them and writes one statistics.json covering all workers.
+    class sharded_wrap_2 {
+    public:
+        // points has to hold the same points as oracle
+        sharded_wrap_2(const Oracle &oracle, const SharedPoints &points);
+
+        // like tiled_wrap_2::run(), n_processes == 0 starts one worker per hardware thread. Throws
+        // std::runtime_error if a worker fails.
+        void run(const AlgorithmConfig &config, const TilingConfig &tiling, const OracleParams &params,
+                 int n_processes);
+
+        const TiledStatistics &get_statistics() const { return tiled_.statistics_; }
+
+        // the tiling, the stitched edges and the statistics
+        tiled_wrap_2 tiled_;
+
+    private:
+        const SharedPoints &points_;
+    };
+}
+
+#endif // AW2_SHARDED_WRAP_2_H
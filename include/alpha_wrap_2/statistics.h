@@ -2,6 +2,7 @@
 #define AW2_STATISTICS_H
 
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include "alpha_wrap_2/traversability.h"
 
@@ -12,9 +13,13 @@ namespace aw2 {
         double gate_processing = 0.0;
         double rule_1_processing = 0.0;
         double rule_2_processing = 0.0;
+        // construction of the local geometry field, part of the oracle preprocessing and not of total_time
+        double local_geometry_field = 0.0;
+        // space-filling curve reordering of the input before the oracle is built, not part of total_time
+        double point_reordering = 0.0;
 
         NLOHMANN_DEFINE_TYPE_INTRUSIVE(TimingStats, total_time, main_loop, gate_processing, rule_1_processing,
-                                       rule_2_processing)
+                                       rule_2_processing, local_geometry_field, point_reordering)
     };
 
     struct ExecutionStats {
@@ -22,8 +27,36 @@ namespace aw2 {
         int n_rule_1 = 0;
         int n_rule_2 = 0;
         int n_input_points = 0;
+        // queue entries dropped because their adjacent faces changed after they were queued
+        int n_stale_gates_skipped = 0;
+        // input points touched by the Rule 2 oracle queries
+        std::size_t n_rule_2_points_visited = 0;
+        // gates pushed to the queue, depends on the schedule since it changes the order of the insertions
+        std::size_t n_gates_queued = 0;
+        // lookups of the adaptive traversability memo, both stay 0 for CONSTANT_ALPHA or a disabled cache
+        std::size_t n_traversability_cache_hits = 0;
+        std::size_t n_traversability_cache_misses = 0;
+        // oracle queries skipped because the rule already failed for the same, unchanged faces
+        int n_rule_1_calls_avoided = 0;
+        int n_rule_2_calls_avoided = 0;
+        // adaptive traversability decided from the local geometry field bounds, or evaluated exactly because the
+        // bounds were inconclusive; all stay 0 without a field
+        std::size_t local_geometry_field_bytes = 0;
+        std::size_t n_field_decisions = 0;
+        std::size_t n_field_refinements = 0;
+        // rounds of batched Steiner point insertion, 0 without batching
+        int n_insertion_rounds = 0;
+        // rounds of speculative gate processing and evaluated gates that were not committed, because they were
+        // stale or the iteration limit was reached
+        int n_speculative_rounds = 0;
+        int n_speculative_gates_discarded = 0;
 
-        NLOHMANN_DEFINE_TYPE_INTRUSIVE(ExecutionStats, n_iterations, n_rule_1, n_rule_2, n_input_points)
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(ExecutionStats, n_iterations, n_rule_1, n_rule_2, n_input_points,
+                                       n_stale_gates_skipped, n_rule_2_points_visited, n_gates_queued,
+                                       n_traversability_cache_hits, n_traversability_cache_misses,
+                                       n_rule_1_calls_avoided, n_rule_2_calls_avoided, local_geometry_field_bytes,
+                                       n_field_decisions, n_field_refinements, n_insertion_rounds,
+                                       n_speculative_rounds, n_speculative_gates_discarded)
     };
 
     struct OutputStats {
@@ -39,9 +72,21 @@ namespace aw2 {
         double offset = 0.0;
         std::string traversability_function;
         TraversabilityParams traversability_params;
+        std::string queue_update_mode;
+        int n_threads = 1;
+        bool modified_alpha_traversability = false;
+        std::string queue_type;
+        // triangulation built with USE_DELAUNAY_HIERARCHY
+        bool delaunay_hierarchy = false;
+        int batch_insertion = 1;
+        int speculative_gates = 1;
+        // order of the input points in the oracle, set by the caller
+        std::string point_order = "FILE";
 
         NLOHMANN_DEFINE_TYPE_INTRUSIVE(ConfigStats, input_file, alpha, offset, traversability_function,
-                                       traversability_params)
+                                       traversability_params, queue_update_mode, n_threads,
+                                       modified_alpha_traversability, queue_type, delaunay_hierarchy,
+                                       batch_insertion, speculative_gates, point_order)
     };
 
     struct AlgorithmStatistics {
@@ -55,6 +100,135 @@ namespace aw2 {
 
         NLOHMANN_DEFINE_TYPE_INTRUSIVE(AlgorithmStatistics, config, output_stats, execution_stats, timings)
     };
+
+    struct TileStats {
+        int ix = 0;
+        int iy = 0;
+        // input points in the tile including its overlap
+        int n_input_points = 0;
+        int n_iterations = 0;
+        // wrap edges of the tile whose midpoint lies in its core
+        int n_edges = 0;
+        // edges of the core along regions enclosed by the input, only exposed by the cut at the tile border
+        int n_enclosed_edges = 0;
+        // building the oracle of the tile and wrapping it, in ms
+        double oracle_time = 0.0;
+        double total_time = 0.0;
+        // worker process that wrapped the tile, 0 if the tiles were wrapped by threads
+        int process = 0;
+
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(TileStats, ix, iy, n_input_points, n_iterations, n_edges, n_enclosed_edges,
+                                       oracle_time, total_time, process)
+    };
+
+    struct TiledStatistics {
+        ConfigStats config;
+        // absolute side length of the tile cores and width of the overlap around them
+        double tile_size = 0.0;
+        double tile_overlap = 0.0;
+        int n_tiles_x = 0;
+        int n_tiles_y = 0;
+        // cell size of the flood fill detecting enclosed regions, 0 if it did not fit into the memory budget
+        double reachability_cell_size = 0.0;
+        // worker processes wrapping the tiles, config.n_threads is the number of threads per process
+        int n_processes = 1;
+        // edges of the stitched result, the seam edges included
+        int n_edges = 0;
+        // edges added to connect the wraps of neighboring tiles
+        int n_seam_edges = 0;
+        // endpoints used by a single edge after stitching, 0 if every wrap component is closed
+        int n_open_endpoints = 0;
+        // tiling, all tiles and stitching; and stitching alone, in ms
+        double total_time = 0.0;
+        double stitching_time = 0.0;
+        // only tiles with input points, in the order they were scheduled
+        std::vector<TileStats> tiles;
+
+        // Export to JSON file
+        void export_to_json(const std::string &filepath) const;
+
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(TiledStatistics, config, tile_size, tile_overlap, n_tiles_x, n_tiles_y,
+                                       reachability_cell_size, n_processes, n_edges, n_seam_edges, n_open_endpoints,
+                                       total_time, stitching_time, tiles)
+    };
+
+    struct ComponentStats {
+        int n_input_points = 0;
+        int n_iterations = 0;
+        int n_edges = 0;
+        // the component lies in a region enclosed by the input, its wrap edges are dropped
+        bool enclosed = false;
+        // building the oracle of the component and wrapping it, in ms
+        double oracle_time = 0.0;
+        double total_time = 0.0;
+
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(ComponentStats, n_input_points, n_iterations, n_edges, enclosed, oracle_time,
+                                       total_time)
+    };
+
+    struct ComponentWrapStatistics {
+        ConfigStats config;
+        // absolute distance up to which points are joined into one component
+        double separation = 0.0;
+        int n_components = 0;
+        int n_enclosed_components = 0;
+        // cell size of the flood fill detecting enclosed components, 0 if it did not fit into the memory budget
+        double reachability_cell_size = 0.0;
+        int n_edges = 0;
+        // clustering, all components and merging; and clustering alone, in ms
+        double total_time = 0.0;
+        double clustering_time = 0.0;
+        // largest component first
+        std::vector<ComponentStats> components;
+
+        // Export to JSON file
+        void export_to_json(const std::string &filepath) const;
+
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(ComponentWrapStatistics, config, separation, n_components,
+                                       n_enclosed_components, reachability_cell_size, n_edges, total_time,
+                                       clustering_time, components)
+    };
+
+    struct BatchFileStats {
+        std::string input_file;
+        std::string output_directory;
+        // false if the file could not be wrapped, error holds the reason
+        bool ok = false;
+        std::string error;
+        int n_input_points = 0;
+        int n_iterations = 0;
+        int n_edges = 0;
+        // reading the file, building the oracle, wrapping and exporting, in ms
+        double latency = 0.0;
+
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(BatchFileStats, input_file, output_directory, ok, error, n_input_points,
+                                       n_iterations, n_edges, latency)
+    };
+
+    struct BatchStatistics {
+        // configuration of every wrap, input_file is the manifest and n_threads the number of concurrent wraps
+        ConfigStats config;
+        int n_files = 0;
+        int n_failed = 0;
+        // input points of the wrapped files
+        std::size_t n_points = 0;
+        // wall clock time of the whole batch, in ms
+        double total_time = 0.0;
+        // throughput over the wall clock time, failed files included in files_per_second
+        double files_per_second = 0.0;
+        double points_per_second = 0.0;
+        // latency percentiles of the wrapped files, in ms
+        double latency_p50 = 0.0;
+        double latency_p99 = 0.0;
+        // in manifest order
+        std::vector<BatchFileStats> files;
+
+        // Export to JSON file
+        void export_to_json(const std::string &filepath) const;
+
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(BatchStatistics, config, n_files, n_failed, n_points, total_time,
+                                       files_per_second, points_per_second, latency_p50, latency_p99, files)
+    };
 } // namespace aw2
 
 #endif // AW2_STATISTICS_H
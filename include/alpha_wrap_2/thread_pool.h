@@ -0,0 +1,56 @@
+#ifndef AW2_THREAD_POOL_H
+#define AW2_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aw2 {
+    // Fixed set of worker threads for data-parallel loops. The calling thread takes part in the work,
+    // so a pool of size n starts n - 1 workers.
+    class ThreadPool {
+    public:
+        // n_threads == 0 uses the number of hardware threads
+        explicit ThreadPool(unsigned n_threads);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // number of threads working on a loop, including the caller
+        unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+        // Calls fn(i) for every i in [0, n) and blocks until all calls returned. The order of the calls is
+        // unspecified. The first exception thrown by fn is rethrown after the loop finished.
+        void parallel_for(std::size_t n, const std::function<void(std::size_t)> &fn);
+
+    private:
+        void worker_loop();
+
+        void run_tasks();
+
+        std::vector<std::thread> workers_;
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+
+        // current loop, only changed while no worker is active
+        const std::function<void(std::size_t)> *task_ = nullptr;
+        std::size_t n_tasks_ = 0;
+        std::atomic<std::size_t> next_task_{0};
+        std::size_t n_active_ = 0;
+        std::uint64_t generation_ = 0;
+        bool stop_ = false;
+        std::exception_ptr error_;
+    };
+}
+
+#endif // AW2_THREAD_POOL_H
@@ -0,0 +1,139 @@
+// Public header for tiled_wrap_2
+#ifndef AW2_TILED_WRAP_2_H
+#define AW2_TILED_WRAP_2_H
+
+#include "alpha_wrap_2/alpha_wrap_2.h"
+#include "alpha_wrap_2/oracle.h"
+#include "alpha_wrap_2/reachability_grid.h"
+#include "alpha_wrap_2/statistics.h"
+#include "alpha_wrap_2/timer.h"
+#include "alpha_wrap_2/types.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace aw2 {
+    struct TilingConfig {
+        // side length of the tile cores in multiples of alpha + offset
+        FT tile_size_factor = 64.0;
+        // width of the overlap added around every core in multiples of alpha + offset
+        FT overlap_factor = 4.0;
+        // tiles wrapped concurrently, 0 uses all hardware threads
+        int n_threads = 0;
+        // build the local geometry field of every tile
+        bool local_field = false;
+    };
+
+    // Wraps a large input as a grid of independent tiles. Every tile gets its own oracle with the input points
+    // in its core and the overlap around it and is wrapped with the absolute alpha and offset of the whole input.
+    // Each tile keeps the wrap edges whose midpoint lies in its core, the remaining gaps at the seams are closed
+    // by connecting the open endpoints of neighboring tiles.
+    // Cutting the input at the tile border opens enclosed regions towards the outside of the tile, so a tile also
+    // wraps them from the inside. A coarse flood fill of the whole input from its bounding box detects these
+    // regions and their edges are dropped. Inside the cores the result then matches a monolithic run up to the
+    // order of the Steiner points, as long as the overlap is wider than the influence of the input outside of it.
+    class tiled_wrap_2 {
+    public:
+        struct Tile {
+            int ix = 0;
+            int iy = 0;
+            // input points in the tile including its overlap, counted by plan()
+            std::size_t n_points = 0;
+            // filled by collect_points() and released by wrap_tile()
+            Points points;
+            // wrap edges of the core
+            std::vector<Segment_2> edges;
+            TileStats stats;
+        };
+
+        explicit tiled_wrap_2(const Oracle &oracle);
+
+        // config is relative to the bounding box of the whole input like for alpha_wrap_2, params are the
+        // absolute oracle parameters; the memory budget is shared by the concurrently wrapped tiles. The tiles
+        // are exported to <output_directory>/tiles, the stitched edges and the statistics to output_directory.
+        void run(const AlgorithmConfig &config, const TilingConfig &tiling, const OracleParams &params);
+
+        // The steps of run(), for drivers that wrap the tiles elsewhere (see sharded_wrap_2).
+        // plan() sets up the tile grid and the flood fill and returns the tiles with input points, largest first.
+        std::vector<Tile> plan(const AlgorithmConfig &config, const TilingConfig &tiling, const OracleParams &params);
+
+        // adds the points of [begin, end) to the given tiles whose grown core contains them
+        template<class InputIterator>
+        void collect_points(InputIterator begin, InputIterator end, std::vector<Tile> &tiles) const;
+
+        // wraps the tile and keeps the edges of its core
+        void wrap_tile(Tile &tile, const AlgorithmConfig &config, const OracleParams &params) const;
+
+        // Stitches the edges of the wrapped tiles, collects the statistics and exports the result. total_timer
+        // runs since the start of the tiling and is paused after stitching, the number of threads and processes
+        // in the statistics is left to the caller.
+        void finish(const std::vector<Tile> &tiles, const AlgorithmConfig &config, Timer &total_timer);
+
+        const TiledStatistics &get_statistics() const { return statistics_; }
+
+        // wrap edges of all tile cores and the seam edges between them
+        std::vector<Segment_2> wrap_edges_;
+
+        TiledStatistics statistics_;
+
+    private:
+        // tile of the core containing (x, y), clamped to the grid
+        int tile_x(FT x) const;
+
+        int tile_y(FT y) const;
+
+        std::int64_t tile_key(const int ix, const int iy) const { return static_cast<std::int64_t>(iy) * nx_ + ix; }
+
+        // calls f(ix, iy) for every tile whose grown core contains p
+        template<class F>
+        void for_each_tile(const Point_2 &p, const F &f) const;
+
+        // connects the open endpoints of different tiles that are at most max_length apart
+        void stitch_seams(const std::vector<Tile> &tiles, FT max_length);
+
+        const Oracle &oracle_;
+
+        FT x0_ = 0.0;
+        FT y0_ = 0.0;
+        FT tile_size_ = 0.0;
+        FT overlap_ = 0.0;
+        int nx_ = 1;
+        int ny_ = 1;
+        // set by plan() from the tiling configuration
+        bool local_field_ = false;
+
+        // cells of half of alpha + offset of the whole input, empty if it does not fit into the memory budget
+        ReachabilityGrid reachability_;
+    };
+
+    template<class F>
+    void tiled_wrap_2::for_each_tile(const Point_2 &p, const F &f) const {
+        const int ix0 = tile_x(p.x() - overlap_), ix1 = tile_x(p.x() + overlap_);
+        const int iy0 = tile_y(p.y() - overlap_), iy1 = tile_y(p.y() + overlap_);
+        for (int iy = iy0; iy <= iy1; ++iy) {
+            for (int ix = ix0; ix <= ix1; ++ix) {
+                f(ix, iy);
+            }
+        }
+    }
+
+    template<class InputIterator>
+    void tiled_wrap_2::collect_points(InputIterator begin, InputIterator end, std::vector<Tile> &tiles) const {
+        std::unordered_map<std::int64_t, std::size_t> tile_index;
+        for (std::size_t i = 0; i < tiles.size(); ++i) {
+            tile_index.emplace(tile_key(tiles[i].ix, tiles[i].iy), i);
+            tiles[i].points.reserve(tiles[i].n_points);
+        }
+        for (; begin != end; ++begin) {
+            const Point_2 &p = *begin;
+            for_each_tile(p, [&](const int ix, const int iy) {
+                if (const auto it = tile_index.find(tile_key(ix, iy)); it != tile_index.end()) {
+                    tiles[it->second].points.push_back(p);
+                }
+            });
+        }
+    }
+}
+
+#endif // AW2_TILED_WRAP_2_H
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <iomanip>
 
 namespace aw2 {
@@ -98,7 +99,7 @@ namespace aw2 {
         bool is_running_;
     };
 
-    // Timer Registry for managing hierarchical timers
+    // Timer Registry for managing hierarchical timers, root timers may be created from several threads
     class TimerRegistry {
     public:
         static TimerRegistry &instance() {
@@ -107,11 +108,24 @@ namespace aw2 {
         }
 
         Timer *create_root_timer(const std::string &name) {
+            std::lock_guard<std::mutex> lock(mutex_);
             root_timers_.push_back(std::make_unique<Timer>(name));
             return root_timers_.back().get();
         }
 
+        // removes a root timer and its children, so that processes running many wraps do not accumulate them
+        void release_root_timer(const Timer *timer) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto it = root_timers_.begin(); it != root_timers_.end(); ++it) {
+                if (it->get() == timer) {
+                    root_timers_.erase(it);
+                    return;
+                }
+            }
+        }
+
         void print_all_hierarchies() const {
+            std::lock_guard<std::mutex> lock(mutex_);
             std::cout << "\n=== TIMING REPORT ===" << std::endl;
             for (const auto &timer: root_timers_) {
                 timer->print_hierarchy();
@@ -121,6 +135,7 @@ namespace aw2 {
         }
 
     private:
+        mutable std::mutex mutex_;
         std::vector<std::unique_ptr<Timer> > root_timers_;
     };
 } // namespace aw2
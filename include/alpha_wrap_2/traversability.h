@@ -2,18 +2,40 @@
 #define AW2_TRAVERSABILITY_H
 
 #include "alpha_wrap_2/types.h"
-#include "alpha_wrap_2/point_set_oracle_2.h"
+#include "alpha_wrap_2/oracle.h"
+#include "alpha_wrap_2/local_geometry_field.h"
 #include <nlohmann/json.hpp>
 
-namespace aw2 {
-    // Forward declarations
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
-    class point_set_oracle_2;
-    using Oracle = point_set_oracle_2;
+namespace aw2 {
+    // Identifies a gate independently of face handles: the two gate vertices and the apexes of the
+    // adjacent faces. Vertices are never removed from the triangulation, so a key stays comparable after
+    // insertions and matches a live edge only if both adjacent faces are still the same.
+    struct GateKey {
+        Delaunay::Vertex_handle source;
+        Delaunay::Vertex_handle target;
+        Delaunay::Vertex_handle apex_inside;
+        Delaunay::Vertex_handle apex_outside;
+
+        bool operator==(const GateKey &other) const {
+            return source == other.source && target == other.target &&
+                   apex_inside == other.apex_inside && apex_outside == other.apex_outside;
+        }
+    };
 
     struct Gate {
         Delaunay::Edge edge;
         FT sq_min_delaunay_rad;
+        GateKey key;
+
+        // circumcenters of the adjacent faces, valid as long as the key matches the triangulation
+        Point_2 cc_inside;
+        Point_2 cc_outside;
+        bool outside_infinite = false;
 
         std::pair<Point_2, Point_2> get_points() const;
 
@@ -89,14 +111,60 @@ namespace aw2 {
         }
     }
 
+    // Memoizes the radius-independent part of the adaptive traversability criteria per pair of gate vertices.
+    // A gate is traversable iff its sq_min_delaunay_rad is at least the stored threshold. The input and the
+    // vertices never change during a run, so entries stay valid. Safe to use from several threads, the map is
+    // split into shards with a mutex each.
+    class TraversabilityCache {
+    public:
+        bool find(const Delaunay::Vertex_handle &v1, const Delaunay::Vertex_handle &v2, FT &sq_threshold);
+
+        void insert(const Delaunay::Vertex_handle &v1, const Delaunay::Vertex_handle &v2, FT sq_threshold);
+
+        void clear();
+
+        std::size_t n_hits() const;
+
+        std::size_t n_misses() const;
+
+    private:
+        using VertexPair = std::pair<Delaunay::Vertex_handle, Delaunay::Vertex_handle>;
+
+        struct VertexPairHash {
+            std::size_t operator()(const VertexPair &p) const;
+        };
+
+        struct Shard {
+            mutable std::mutex mutex;
+            std::unordered_map<VertexPair, FT, VertexPairHash> entries;
+            std::size_t n_hits = 0;
+            std::size_t n_misses = 0;
+        };
+
+        Shard &shard(const VertexPair &p) { return shards_[VertexPairHash()(p) % shards_.size()]; }
+
+        std::array<Shard, 64> shards_;
+    };
+
+    // Traversability criteria. The implementations are final, so the main loop, which is instantiated per
+    // criterion, calls them without virtual dispatch.
     class Traversability {
     public:
         virtual ~Traversability() = default;
 
         virtual bool operator()(Gate &g) = 0;
+
+        // gates decided from the local geometry field alone, and gates that needed the exact evaluation
+        std::size_t n_field_decisions() const { return n_field_decisions_.load(std::memory_order_relaxed); }
+
+        std::size_t n_field_refinements() const { return n_field_refinements_.load(std::memory_order_relaxed); }
+
+    protected:
+        std::atomic<std::size_t> n_field_decisions_{0};
+        std::atomic<std::size_t> n_field_refinements_{0};
     };
 
-    class ConstantAlphaTraversability : public Traversability {
+    class ConstantAlphaTraversability final : public Traversability {
     public:
         ConstantAlphaTraversability(const FT alpha) : alpha_(alpha) {
         }
@@ -109,20 +177,28 @@ namespace aw2 {
         FT alpha_;
     };
 
-    class DeviationBasedTraversability : public Traversability {
+    class DeviationBasedTraversability final : public Traversability {
     public:
+        // cache and field may be null
         DeviationBasedTraversability(const FT alpha, const FT offset, const FT bbox_diagonal_length,
-                                     const Oracle &oracle, const DeviationBasedParams &params)
+                                     const Oracle &oracle, const DeviationBasedParams &params,
+                                     TraversabilityCache *cache = nullptr, const LocalGeometryField *field = nullptr)
             : alpha_(alpha), offset_(offset), oracle_(oracle),
               alpha_max_(params.alpha_max * bbox_diagonal_length), point_threshold_(params.point_threshold),
-              deviation_factor_(params.deviation_factor) {
+              deviation_factor_(params.deviation_factor), cache_(cache), field_(field) {
         }
 
         bool operator()(Gate &g) override;
 
     private:
-        FT subsegment_deviation(const Segment_2 &seg) const;
+        // deviation of a sub-segment from the n input points in its box and their summed squared distance
+        FT subsegment_deviation(int n, FT sum_sq_deviation) const;
 
+        // Bounds the deviation of every sub-segment with the local geometry field. Returns false if the bounds
+        // do not decide the gate, otherwise traversable is set.
+        bool field_decides(const Segment_2 &seg, FT sq_radius, bool &traversable) const;
+
+        // maximum deviation over the sub-segments of length alpha, evaluated with a single oracle query
         FT segment_deviation(const Segment_2 &seg) const;
 
         FT alpha_;
@@ -131,23 +207,36 @@ namespace aw2 {
         FT alpha_max_;
         int point_threshold_;
         FT deviation_factor_;
+        TraversabilityCache *cache_;
+        const LocalGeometryField *field_;
     };
 
-    class IntersectionBasedTraversability : public Traversability {
+    class IntersectionBasedTraversability final : public Traversability {
     public:
+        // cache and field may be null
         IntersectionBasedTraversability(const FT alpha, const FT offset, const FT bbox_diagonal_length,
-                                        const Oracle &oracle, const IntersectionBasedParams &params)
+                                        const Oracle &oracle, const IntersectionBasedParams &params,
+                                        TraversabilityCache *cache = nullptr,
+                                        const LocalGeometryField *field = nullptr)
             : alpha_(alpha), offset_(offset), oracle_(oracle),
-              tolerance_(params.tolerance_factor * bbox_diagonal_length) {
+              tolerance_(params.tolerance_factor * bbox_diagonal_length), cache_(cache), field_(field) {
         }
 
         bool operator()(Gate &g) override;
 
     private:
+        bool deviates(const Point_2 &s, const Point_2 &t) const;
+
+        // true if the local geometry field shows that the normal segment of a sample cannot reach the offset
+        // surface, which makes the gate traversable
+        bool field_clears(const Point_2 &s, const Point_2 &t) const;
+
         FT alpha_;
         FT offset_;
         const Oracle &oracle_;
         FT tolerance_;
+        TraversabilityCache *cache_;
+        const LocalGeometryField *field_;
     };
 }
 
@@ -11,6 +11,11 @@
 #include <CGAL/Triangulation_face_base_with_info_2.h>
 #include <CGAL/Triangulation_data_structure_2.h>
 
+#ifdef USE_DELAUNAY_HIERARCHY
+#include <CGAL/Triangulation_hierarchy_vertex_base_2.h>
+#include <CGAL/Triangulation_hierarchy_2.h>
+#endif
+
 namespace aw2 {
     enum FaceLabel { INSIDE, OUTSIDE };
 
@@ -20,11 +25,81 @@ namespace aw2 {
     typedef std::vector<Point_2> Points;
     typedef K::Segment_2 Segment_2;
 
+    // Face base storing the label of the face, a cache of its circumcenter and squared circumradius and the
+    // negative outcomes of the rules for the face. CGAL may reuse a face for a different triangle during an
+    // insertion, the owner has to refresh the cache of every face incident to an inserted vertex and the
+    // Rule 1 outcome of their neighbors.
+    template<class Gt, class Fb0 = CGAL::Triangulation_face_base_with_info_2<FaceLabel, Gt> >
+    class Face_base_with_circumcenter_2 : public Fb0 {
+    public:
+        typedef typename Fb0::Vertex_handle Vertex_handle;
+        typedef typename Fb0::Face_handle Face_handle;
+
+        template<typename TDS2>
+        struct Rebind_TDS {
+            typedef typename Fb0::template Rebind_TDS<TDS2>::Other Fb2;
+            typedef Face_base_with_circumcenter_2<Gt, Fb2> Other;
+        };
+
+        Face_base_with_circumcenter_2() : Fb0() {
+        }
+
+        Face_base_with_circumcenter_2(Vertex_handle v0, Vertex_handle v1, Vertex_handle v2)
+            : Fb0(v0, v1, v2) {
+        }
+
+        Face_base_with_circumcenter_2(Vertex_handle v0, Vertex_handle v1, Vertex_handle v2,
+                                      Face_handle n0, Face_handle n1, Face_handle n2)
+            : Fb0(v0, v1, v2, n0, n1, n2) {
+        }
+
+        void set_cached_circumcenter(const typename Gt::Point_2 &cc, const typename Gt::FT sq_radius) {
+            cc_ = cc;
+            sq_radius_ = sq_radius;
+        }
+
+        const typename Gt::Point_2 &cached_circumcenter() const { return cc_; }
+
+        typename Gt::FT cached_sq_radius() const { return sq_radius_; }
+
+        // Rule 1 found no offset surface intersection between this face (inside) and its neighbor i
+        bool rule_1_negative(const int i) const { return rule_1_negative_ & (1u << i); }
+
+        void set_rule_1_negative(const int i) { rule_1_negative_ |= 1u << i; }
+
+        void reset_rule_1(const int i) { rule_1_negative_ &= ~(1u << i); }
+
+        // Rule 2 found no input point in the face
+        bool rule_2_negative() const { return rule_2_negative_; }
+
+        void set_rule_2_negative() { rule_2_negative_ = true; }
+
+        void reset_rules() {
+            rule_1_negative_ = 0;
+            rule_2_negative_ = false;
+        }
+
+    private:
+        typename Gt::Point_2 cc_;
+        typename Gt::FT sq_radius_ = 0;
+        unsigned char rule_1_negative_ = 0;
+        bool rule_2_negative_ = false;
+    };
+
+    typedef Face_base_with_circumcenter_2<K> Fb;
+
+    // With USE_DELAUNAY_HIERARCHY point location walks down a hierarchy of sparser triangulations, which keeps
+    // the locate step of an insertion without a good hint logarithmic in the number of vertices.
+#ifdef USE_DELAUNAY_HIERARCHY
+    typedef CGAL::Triangulation_hierarchy_vertex_base_2<CGAL::Triangulation_vertex_base_2<K> > Vb;
+    typedef CGAL::Triangulation_data_structure_2<Vb, Fb> Tds;
+    typedef CGAL::Triangulation_hierarchy_2<CGAL::Delaunay_triangulation_2<K, Tds> > Delaunay;
+#else
     typedef CGAL::Triangulation_vertex_base_2<K> Vb;
-    typedef CGAL::Triangulation_face_base_with_info_2<FaceLabel, K> Fb;
     typedef CGAL::Triangulation_data_structure_2<Vb, Fb> Tds;
 
     typedef CGAL::Delaunay_triangulation_2<K, Tds> Delaunay;
+#endif
     typedef Delaunay::Vertex_handle Vertex_handle;
     typedef Delaunay::Face_handle Face_handle;
 }
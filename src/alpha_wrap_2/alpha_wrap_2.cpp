@@ -1,18 +1,22 @@
 #include <alpha_wrap_2/alpha_wrap_2.h>
+
+#include <CGAL/spatial_sort.h>
+#include <CGAL/Spatial_sort_traits_adapter_2.h>
+#include <CGAL/property_map.h>
+
+#include <algorithm>
 #include <ctime>
+#include <numeric>
 #include <sstream>
 
 
 namespace aw2 {
     alpha_wrap_2::alpha_wrap_2(const Oracle &oracle)
-        : oracle_(oracle),
-          traversability_(nullptr),
-          exporter_(nullptr) {
+        : oracle_(oracle) {
     }
 
     alpha_wrap_2::~alpha_wrap_2() {
-        delete traversability_;
-        delete exporter_;
+        registry_.release_root_timer(total_timer_);
     }
 
     void alpha_wrap_2::run() {
@@ -25,56 +29,7 @@ namespace aw2 {
         total_timer_->start();
         main_loop_timer_->start();
 
-        while (!queue_.empty()) {
-            if (++iteration_ > max_iterations_) {
-                std::cout << "Reached maximum number of iterations (" << max_iterations_ << "). Stopping." << std::endl;
-                break;
-            }
-
-            // ** Get candidate gate **
-            candidate_gate_ = queue_.top();
-            queue_.pop();
-
-            export_step_ = ((iteration_ % config_.intermediate_steps) == 0 && (iteration_ < config_.export_step_limit));
-            if (export_step_) {
-                exporter_->candidate_edge_ = Segment_2(
-                    candidate_gate_.get_points().first,
-                    candidate_gate_.get_points().second
-                );
-            }
-
-            // ** Get candidate gate info **
-            gate_processing_timer_->start();
-
-            auto info = gate_adjacency_info(candidate_gate_.edge);
-            auto c_in = candidate_gate_.edge.first;
-            auto c_in_cc = info.cc_inside;
-            auto c_out_cc = info.cc_outside;
-
-            gate_processing_timer_->pause();
-
-            // ** Process rule 1 **
-            if (process_rule_1(c_in_cc, c_out_cc)) {
-                statistics_.execution_stats.n_rule_1++;
-                continue;
-            }
-
-            // ** Process rule 2 **
-            if (process_rule_2(c_in, c_in_cc)) {
-                statistics_.execution_stats.n_rule_2++;
-                continue;
-            }
-
-            // ** Carve face **
-            if (export_step_) {
-                exporter_->export_svg("iteration_" + std::to_string(iteration_) + "_0", ITERATION_CARVE);
-            }
-            c_in->info() = OUTSIDE;
-            if (export_step_) {
-                exporter_->export_svg("iteration_" + std::to_string(iteration_) + "_1", ITERATION_CARVE);
-            }
-            update_queue(c_in);
-        }
+        (this->*main_loop_)();
 
         main_loop_timer_->pause();
 
@@ -86,8 +41,10 @@ namespace aw2 {
         total_timer_->pause();
 
         // Export result and collect statistics
-        exporter_->style_.draw_candidate_edge = false;
-        exporter_->export_svg("final_result");
+        if (config_.export_results) {
+            exporter_->style_.draw_candidate_edge = false;
+            exporter_->export_svg("final_result");
+        }
 
         statistics_.execution_stats.n_iterations = iteration_;
         statistics_.timings.total_time = total_timer_->elapsed_ms();
@@ -99,20 +56,31 @@ namespace aw2 {
         statistics_.output_stats.n_vertices = dt_.number_of_vertices();
         statistics_.output_stats.n_edges = wrap_edges_.size();
 
-        statistics_.execution_stats.n_input_points = oracle_.tree_.size();
+        statistics_.execution_stats.n_input_points = oracle_.size();
+        statistics_.execution_stats.n_traversability_cache_hits = traversability_cache_.n_hits();
+        statistics_.execution_stats.n_traversability_cache_misses = traversability_cache_.n_misses();
+        statistics_.execution_stats.local_geometry_field_bytes = oracle_.local_geometry_field().stats().memory_bytes;
+        statistics_.execution_stats.n_field_decisions = traversability_->n_field_decisions();
+        statistics_.execution_stats.n_field_refinements = traversability_->n_field_refinements();
+        statistics_.timings.local_geometry_field = oracle_.local_geometry_field().stats().build_time_ms;
 
         // Export statistics to JSON
-        std::string stats_filepath = exporter_->export_dir_.string() + "/statistics.json";
-        statistics_.export_to_json(stats_filepath);
+        if (config_.export_results) {
+            std::string stats_filepath = exporter_->export_dir_.string() + "/statistics.json";
+            statistics_.export_to_json(stats_filepath);
+        }
 
         // Print hierarchical timing report
-        registry_.print_all_hierarchies();
-        std::cout << "Total iterations: " << iteration_ << std::endl;
+        if (config_.print_report) {
+            registry_.print_all_hierarchies();
+            std::cout << "Total iterations: " << iteration_ << std::endl;
+        }
     }
 
 
     void alpha_wrap_2::init(const AlgorithmConfig &config) {
-        // Create hierarchical timer structure
+        // Create hierarchical timer structure, replacing the one of a previous init()
+        registry_.release_root_timer(total_timer_);
         total_timer_ = registry_.create_root_timer("Alpha Wrap Algorithm");
         init_timer_ = total_timer_->create_child("Initialization");
         main_loop_timer_ = total_timer_->create_child("Main Loop");
@@ -126,10 +94,7 @@ namespace aw2 {
 
         // Compute bounding box diagonal length
         auto [x_min, x_max, y_min, y_max] = oracle_.bbox_;
-        bbox_diagonal_length_ = std::sqrt(CGAL::squared_distance(
-            Point_2(x_min, y_min),
-            Point_2(x_max, y_max)
-        ));
+        bbox_diagonal_length_ = oracle_.bbox_diagonal_length();
 
         // apply configuration
 
@@ -140,42 +105,75 @@ namespace aw2 {
         config_ = config;
 
         // Populate config stats
-        statistics_.config.alpha = config.alpha;
-        statistics_.config.offset = config.offset;
-        statistics_.config.traversability_params = config.traversability_params;
+        fill_config_stats(config, statistics_.config);
+        if (config.batch_insertion > 1 && config.speculative_gates > 1) {
+            throw std::invalid_argument("Batched insertion and speculative gate processing cannot be combined.");
+        }
+        speculation_timer_ = config.speculative_gates > 1
+                                 ? main_loop_timer_->create_child("Speculative Rule Evaluation")
+                                 : nullptr;
+        thread_pool_.reset();
+        if (config.n_threads != 1) {
+            thread_pool_ = std::make_unique<ThreadPool>(std::max(0, config.n_threads));
+        }
+        statistics_.config.n_threads = thread_pool_ ? static_cast<int>(thread_pool_->size()) : 1;
 
         // Set traversability object
+        traversability_cache_.clear();
+        TraversabilityCache *cache = config.traversability_cache ? &traversability_cache_ : nullptr;
+        const LocalGeometryField *field = oracle_.local_geometry_field().empty()
+                                              ? nullptr
+                                              : &oracle_.local_geometry_field();
         switch (config.traversability_method) {
             case CONSTANT_ALPHA:
-                traversability_ = new ConstantAlphaTraversability(alpha_);
-                statistics_.config.traversability_function = "CONSTANT_ALPHA";
+                traversability_ = std::make_unique<ConstantAlphaTraversability>(alpha_);
                 break;
             case DEVIATION_BASED:
-                traversability_ = new DeviationBasedTraversability(
+                traversability_ = std::make_unique<DeviationBasedTraversability>(
                     alpha_,
                     offset_,
                     bbox_diagonal_length_,
                     oracle_,
-                    std::get<DeviationBasedParams>(config.traversability_params)
+                    std::get<DeviationBasedParams>(config.traversability_params),
+                    cache,
+                    field
                 );
-                statistics_.config.traversability_function = "DEVIATION_BASED";
 
                 break;
             case INTERSECTION_BASED:
-                traversability_ = new IntersectionBasedTraversability(
+                traversability_ = std::make_unique<IntersectionBasedTraversability>(
                     alpha_,
                     offset_,
                     bbox_diagonal_length_,
                     oracle_,
-                    std::get<IntersectionBasedParams>(config.traversability_params)
+                    std::get<IntersectionBasedParams>(config.traversability_params),
+                    cache,
+                    field
                 );
-                statistics_.config.traversability_function = "INTERSECTION_BASED";
 
                 break;
             default:
                 throw std::invalid_argument("Unknown traversability method.");
         }
 
+        // the traversability, radius and queue variants are fixed for the whole run,
+        // so the main loop is instantiated for them once here
+        if (config.dynamic_traversability) {
+            select_radius_policy<Traversability>();
+        } else {
+            switch (config.traversability_method) {
+                case CONSTANT_ALPHA:
+                    select_radius_policy<ConstantAlphaTraversability>();
+                    break;
+                case DEVIATION_BASED:
+                    select_radius_policy<DeviationBasedTraversability>();
+                    break;
+                case INTERSECTION_BASED:
+                    select_radius_policy<IntersectionBasedTraversability>();
+                    break;
+            }
+        }
+
         // Insert bounding box points
         const FT margin = offset_ + bbox_diagonal_length_ / 10.0;
         dt_bbox_min_ = Point_2(x_min - margin, y_min - margin);
@@ -188,6 +186,9 @@ namespace aw2 {
             {x_max + margin, y_max + margin}
         };
         dt_.insert(pts_bbox.begin(), pts_bbox.end());
+        for (auto fit = dt_.all_faces_begin(); fit != dt_.all_faces_end(); ++fit) {
+            cache_face_geometry(fit);
+        }
 
         // add all boundary edges to the queue and set the face labels
         for (auto eit = dt_.finite_edges_begin(); eit != dt_.finite_edges_end(); ++eit) {
@@ -205,23 +206,494 @@ namespace aw2 {
             }
 
             // add gate to queue
-            add_gate_to_queue(*eit);
+            (this->*add_gate_to_queue_)(*eit);
         }
 
         // Initialize exporter after configuration is applied
-        exporter_ = new alpha_wrap_2_exporter(*this, config_);
-        exporter_->setup_export_dir(config_.output_directory);
+        exporter_ = std::make_unique<alpha_wrap_2_exporter>(*this, config_);
+        if (config_.export_results || config_.export_step_limit > 0) {
+            exporter_->setup_export_dir(config_.output_directory);
+        }
 
         init_timer_->pause();
         total_timer_->pause();
     }
 
+    void fill_config_stats(const AlgorithmConfig &config, ConfigStats &stats) {
+        stats.alpha = config.alpha;
+        stats.offset = config.offset;
+        switch (config.traversability_method) {
+            case CONSTANT_ALPHA:
+                stats.traversability_function = "CONSTANT_ALPHA";
+                break;
+            case DEVIATION_BASED:
+                stats.traversability_function = "DEVIATION_BASED";
+                break;
+            case INTERSECTION_BASED:
+                stats.traversability_function = "INTERSECTION_BASED";
+                break;
+        }
+        stats.traversability_params = config.traversability_params;
+        stats.queue_update_mode = config.queue_update_mode == INCREMENTAL ? "INCREMENTAL" : "FULL_RESCAN";
+        stats.modified_alpha_traversability = config.modified_alpha_traversability;
+        stats.queue_type = queue_type_name(config.queue_type);
+        stats.batch_insertion = std::max(1, config.batch_insertion);
+        stats.speculative_gates = std::max(1, config.speculative_gates);
+#ifdef USE_DELAUNAY_HIERARCHY
+        stats.delaunay_hierarchy = true;
+#endif
+    }
+
+    AlgorithmConfig rescaled_config(const AlgorithmConfig &config, const FT scale) {
+        AlgorithmConfig result = config;
+        result.alpha = config.alpha * scale;
+        result.offset = config.offset * scale;
+        if (auto *p = std::get_if<DeviationBasedParams>(&result.traversability_params)) {
+            p->alpha_max *= scale;
+        } else if (auto *q = std::get_if<IntersectionBasedParams>(&result.traversability_params)) {
+            q->tolerance_factor *= scale;
+        }
+        return result;
+    }
+
+    std::string queue_type_name(const QueueType type) {
+        switch (type) {
+            case PRIORITY_QUEUE:
+                return "PRIORITY_QUEUE";
+            case STACK_QUEUE:
+                return "STACK_QUEUE";
+            case BUCKET_QUEUE:
+                return "BUCKET_QUEUE";
+            case DARY_HEAP:
+                return "DARY_HEAP";
+        }
+        throw std::invalid_argument("Unknown queue type.");
+    }
+
+    QueueType queue_type_from_name(const std::string &name) {
+        for (const auto type: {PRIORITY_QUEUE, STACK_QUEUE, BUCKET_QUEUE, DARY_HEAP}) {
+            if (queue_type_name(type) == name) return type;
+        }
+        throw std::invalid_argument("Unknown queue type: " + name);
+    }
+
     bool alpha_wrap_2::is_gate(const Delaunay::Edge &e) {
         const auto c_in = e.first;
         const auto c_out = c_in->neighbor(e.second);
         return c_in->info() != c_out->info();
     }
 
+    template<class TraversabilityT>
+    void alpha_wrap_2::select_radius_policy() {
+        if (config_.modified_alpha_traversability) {
+            select_queue_policy<TraversabilityT, true>();
+        } else {
+            select_queue_policy<TraversabilityT, false>();
+        }
+    }
+
+    template<class TraversabilityT, bool ModifiedAlpha>
+    void alpha_wrap_2::select_queue_policy() {
+        switch (config_.queue_type) {
+            case PRIORITY_QUEUE:
+                apply_policy<WrapPolicy<TraversabilityT, ModifiedAlpha, HeapGateQueue> >();
+                break;
+            case STACK_QUEUE:
+                apply_policy<WrapPolicy<TraversabilityT, ModifiedAlpha, StackGateQueue> >();
+                break;
+            case BUCKET_QUEUE:
+                apply_policy<WrapPolicy<TraversabilityT, ModifiedAlpha, BucketGateQueue> >();
+                break;
+            case DARY_HEAP:
+                apply_policy<WrapPolicy<TraversabilityT, ModifiedAlpha, DaryGateQueue> >();
+                break;
+            default:
+                throw std::invalid_argument("Unknown queue type.");
+        }
+    }
+
+    template<class Policy>
+    void alpha_wrap_2::apply_policy() {
+        queue_.emplace<typename Policy::Queue>();
+        if (config_.speculative_gates > 1) {
+            main_loop_ = &alpha_wrap_2::main_loop_speculative<Policy>;
+        } else if (config_.batch_insertion > 1) {
+            main_loop_ = &alpha_wrap_2::main_loop_batched<Policy>;
+        } else {
+            main_loop_ = &alpha_wrap_2::main_loop<Policy>;
+        }
+        add_gate_to_queue_ = &alpha_wrap_2::add_gate_to_queue<Policy>;
+    }
+
+    template<class Policy>
+    void alpha_wrap_2::main_loop() {
+        // ** Get candidate gate **
+        while (pop_gate<Policy>(candidate_gate_)) {
+            if (++iteration_ > max_iterations_) {
+                std::cout << "Reached maximum number of iterations (" << max_iterations_ << "). Stopping." << std::endl;
+                break;
+            }
+
+            export_step_ = (config_.intermediate_steps > 0 && (iteration_ % config_.intermediate_steps) == 0 &&
+                            (iteration_ < config_.export_step_limit));
+            if (export_step_) {
+                exporter_->candidate_edge_ = Segment_2(
+                    candidate_gate_.get_points().first,
+                    candidate_gate_.get_points().second
+                );
+            }
+
+            // ** Get candidate gate info **
+            // the circumcenters were cached when the gate was queued and are still valid after refresh_gate
+            auto c_in = candidate_gate_.edge.first;
+            auto c_in_cc = candidate_gate_.cc_inside;
+            auto c_out_cc = candidate_gate_.cc_outside;
+
+            // ** Process rule 1 **
+            Point_2 steiner_point;
+            if (process_rule_1(candidate_gate_.edge, c_in_cc, c_out_cc, steiner_point)) {
+                statistics_.execution_stats.n_rule_1++;
+                insert_steiner_point<Policy>(steiner_point, c_in);
+                continue;
+            }
+
+            // ** Process rule 2 **
+            if (process_rule_2(c_in, c_in_cc, steiner_point)) {
+                statistics_.execution_stats.n_rule_2++;
+                insert_steiner_point<Policy>(steiner_point, c_in);
+                continue;
+            }
+
+            // ** Carve face **
+            if (export_step_) {
+                exporter_->export_svg("iteration_" + std::to_string(iteration_) + "_0", ITERATION_CARVE);
+            }
+            c_in->info() = OUTSIDE;
+            if (export_step_) {
+                exporter_->export_svg("iteration_" + std::to_string(iteration_) + "_1", ITERATION_CARVE);
+            }
+            update_queue<Policy>(c_in);
+        }
+    }
+
+    template<class Policy>
+    void alpha_wrap_2::main_loop_batched() {
+        const auto batch_size = static_cast<std::size_t>(config_.batch_insertion);
+        auto &queue = this->queue<Policy>();
+
+        bool done = false;
+        while (!done) {
+            batch_points_.clear();
+            batch_hints_.clear();
+            batch_touched_faces_.clear();
+
+            // ** Collect the Steiner points of a round **
+            // Rules and carving see the triangulation of the round start, which is exact for a gate whose faces
+            // are outside the conflict zones collected so far: they survive the insertions of the round.
+            while (batch_points_.size() < batch_size) {
+                if (!pop_gate<Policy>(candidate_gate_)) {
+                    done = true;
+                    break;
+                }
+
+                auto c_in = candidate_gate_.edge.first;
+                const auto c_out = c_in->neighbor(candidate_gate_.edge.second);
+                if (batch_touched_faces_.count(&*c_in) || batch_touched_faces_.count(&*c_out)) {
+                    queue.push(candidate_gate_);
+                    break;
+                }
+
+                if (++iteration_ > max_iterations_) {
+                    std::cout << "Reached maximum number of iterations (" << max_iterations_ << "). Stopping." <<
+                            std::endl;
+                    done = true;
+                    break;
+                }
+
+                // ** Evaluate rules 1 and 2 **
+                // without side effects, a gate whose Steiner point interacts with the round is evaluated again
+                // in the next round and only counted and exported then
+                auto &s = batch_gate_;
+                s.gate = candidate_gate_;
+                rule1_timer_->start();
+                evaluate_rule_1(s);
+                rule1_timer_->pause();
+                if (!s.rule_1) {
+                    rule2_timer_->start();
+                    evaluate_rule_2(s);
+                    rule2_timer_->pause();
+                }
+
+                if (s.rule_1 || s.rule_2) {
+                    batch_conflicts_.clear();
+                    dt_.get_conflicts(s.steiner_point, std::back_inserter(batch_conflicts_), c_in);
+                    const bool interacts = std::any_of(batch_conflicts_.begin(), batch_conflicts_.end(),
+                                                       [&](const Delaunay::Face_handle &f) {
+                                                           return batch_touched_faces_.count(&*f) > 0;
+                                                       });
+                    if (interacts) {
+                        queue.push(candidate_gate_);
+                        --iteration_;
+                        break;
+                    }
+                }
+
+                export_step_ = (config_.intermediate_steps > 0 && (iteration_ % config_.intermediate_steps) == 0 &&
+                                (iteration_ < config_.export_step_limit));
+                if (export_step_) {
+                    exporter_->candidate_edge_ = Segment_2(
+                        candidate_gate_.get_points().first,
+                        candidate_gate_.get_points().second
+                    );
+                }
+
+                if (commit_rules(s)) {
+                    for (const auto &f: batch_conflicts_) {
+                        batch_touched_faces_.insert(&*f);
+                    }
+                    batch_points_.push_back(s.steiner_point);
+                    // a face of the conflict zone is only destroyed by the insertion of this point, c_in might
+                    // not survive the round
+                    batch_hints_.push_back(batch_conflicts_.empty() ? Delaunay::Face_handle()
+                                                                    : batch_conflicts_.front());
+                    continue;
+                }
+
+                // ** Carve face **
+                if (export_step_) {
+                    exporter_->export_svg("iteration_" + std::to_string(iteration_) + "_0", ITERATION_CARVE);
+                }
+                c_in->info() = OUTSIDE;
+                if (export_step_) {
+                    exporter_->export_svg("iteration_" + std::to_string(iteration_) + "_1", ITERATION_CARVE);
+                }
+                update_queue<Policy>(c_in);
+            }
+
+            if (batch_points_.empty()) continue;
+
+            // ** Insert the round in Hilbert order, then update the queue once **
+            batch_order_.resize(batch_points_.size());
+            std::iota(batch_order_.begin(), batch_order_.end(), 0);
+            using Sort_traits = CGAL::Spatial_sort_traits_adapter_2<K, CGAL::Pointer_property_map<Point_2>::type>;
+            CGAL::spatial_sort(batch_order_.begin(), batch_order_.end(),
+                               Sort_traits(CGAL::make_property_map(batch_points_)));
+
+            batch_vertices_.clear();
+            for (const auto i: batch_order_) {
+                batch_vertices_.push_back(insert_vertex(batch_points_[i], batch_hints_[i]));
+            }
+            statistics_.execution_stats.n_insertion_rounds++;
+
+            gate_processing_timer_->start();
+            if (config_.queue_update_mode == INCREMENTAL) {
+                for (const auto &vh: batch_vertices_) {
+                    repair_queue<Policy>(vh);
+                }
+            } else {
+                rebuild_queue<Policy>();
+            }
+            gate_processing_timer_->pause();
+        }
+    }
+
+    template<class Policy>
+    void alpha_wrap_2::main_loop_speculative() {
+        const auto round_size = static_cast<std::size_t>(config_.speculative_gates);
+
+        bool done = false;
+        while (!done) {
+            // ** Pop the top gates and evaluate their rules concurrently **
+            speculative_gates_.clear();
+            Gate g;
+            while (speculative_gates_.size() < round_size && pop_gate<Policy>(g)) {
+                speculative_gates_.push_back({});
+                speculative_gates_.back().gate = g;
+            }
+            if (speculative_gates_.empty()) break;
+
+            speculation_timer_->start();
+            if (thread_pool_) {
+                thread_pool_->parallel_for(speculative_gates_.size(), [this](const std::size_t i) {
+                    evaluate_rules(speculative_gates_[i]);
+                });
+            } else {
+                for (auto &s: speculative_gates_) evaluate_rules(s);
+            }
+            speculation_timer_->pause();
+
+            // ** Commit in queue order **
+            // A gate whose two faces still exist (same vertices) sees the same circumcenters and triangle, so its
+            // rule outcomes are still valid. Otherwise it is stale and dropped like in pop_gate.
+            bool changed = false;
+            for (std::size_t k = 0; k < speculative_gates_.size(); ++k) {
+                auto &s = speculative_gates_[k];
+                if (changed && !refresh_gate(s.gate)) {
+                    statistics_.execution_stats.n_stale_gates_skipped++;
+                    statistics_.execution_stats.n_speculative_gates_discarded++;
+                    continue;
+                }
+
+                if (++iteration_ > max_iterations_) {
+                    std::cout << "Reached maximum number of iterations (" << max_iterations_ << "). Stopping." <<
+                            std::endl;
+                    // this and the remaining gates of the round were evaluated but are not committed
+                    statistics_.execution_stats.n_speculative_gates_discarded +=
+                            static_cast<int>(speculative_gates_.size() - k);
+                    done = true;
+                    break;
+                }
+
+                candidate_gate_ = s.gate;
+                export_step_ = (config_.intermediate_steps > 0 && (iteration_ % config_.intermediate_steps) == 0 &&
+                                (iteration_ < config_.export_step_limit));
+                if (export_step_) {
+                    exporter_->candidate_edge_ = Segment_2(
+                        candidate_gate_.get_points().first,
+                        candidate_gate_.get_points().second
+                    );
+                }
+                changed = true;
+
+                auto c_in = candidate_gate_.edge.first;
+
+                // ** Rules 1 and 2 **
+                if (commit_rules(s)) {
+                    insert_steiner_point<Policy>(s.steiner_point, c_in);
+                    continue;
+                }
+
+                // ** Carve face **
+                if (export_step_) {
+                    exporter_->export_svg("iteration_" + std::to_string(iteration_) + "_0", ITERATION_CARVE);
+                }
+                c_in->info() = OUTSIDE;
+                if (export_step_) {
+                    exporter_->export_svg("iteration_" + std::to_string(iteration_) + "_1", ITERATION_CARVE);
+                }
+                update_queue<Policy>(c_in);
+            }
+            statistics_.execution_stats.n_speculative_rounds++;
+        }
+    }
+
+    void alpha_wrap_2::evaluate_rules(SpeculativeGate &s) const {
+        evaluate_rule_1(s);
+        if (!s.rule_1) evaluate_rule_2(s);
+    }
+
+    void alpha_wrap_2::evaluate_rule_1(SpeculativeGate &s) const {
+        // same query as process_rule_1, resets the outcome of Rule 2
+        const auto &g = s.gate;
+        s.rule_1_known_negative = g.edge.first->rule_1_negative(g.edge.second);
+        s.rule_1 = !s.rule_1_known_negative &&
+                   oracle_.first_intersection(g.cc_outside, g.cc_inside, s.steiner_point, offset_);
+        s.rule_2_known_negative = false;
+        s.rule_2 = false;
+    }
+
+    void alpha_wrap_2::evaluate_rule_2(SpeculativeGate &s) const {
+        // same query as process_rule_2
+        const auto &g = s.gate;
+        const auto c_in = g.edge.first;
+        s.rule_2_known_negative = c_in->rule_2_negative();
+        s.rule_2 = false;
+        if (s.rule_2_known_negative) return;
+
+        s.rule_2 = oracle_.rule_2_query(dt_.triangle(c_in), g.cc_inside, offset_, s.rule_2_query);
+        if (s.rule_2) {
+            if (!s.rule_2_query.intersects) {
+                throw std::runtime_error("Error: R2 failed to compute intersection point.");
+            }
+            s.steiner_point = s.rule_2_query.steiner_point;
+        }
+    }
+
+    bool alpha_wrap_2::commit_rules(const SpeculativeGate &s) {
+        const auto &g = s.gate;
+        const auto c_in = g.edge.first;
+
+        // ** Rule 1 **
+        if (s.rule_1_known_negative) {
+            statistics_.execution_stats.n_rule_1_calls_avoided++;
+        } else if (!s.rule_1) {
+            c_in->set_rule_1_negative(g.edge.second);
+        }
+        if (s.rule_1) {
+            statistics_.execution_stats.n_rule_1++;
+            if (export_step_) {
+                exporter_->rule_segment_ = Segment_2(g.cc_outside, g.cc_inside);
+                exporter_->steiner_point_ = s.steiner_point;
+                exporter_->export_svg("iteration_" + std::to_string(iteration_), ITERATION_RULE);
+            }
+            return true;
+        }
+
+        // ** Rule 2 **
+        if (s.rule_2_known_negative) {
+            statistics_.execution_stats.n_rule_2_calls_avoided++;
+        } else {
+            statistics_.execution_stats.n_rule_2_points_visited += s.rule_2_query.n_visited;
+            if (!s.rule_2) c_in->set_rule_2_negative();
+        }
+        if (s.rule_2) {
+            statistics_.execution_stats.n_rule_2++;
+            if (export_step_) {
+                exporter_->rule_segment_ = Segment_2(g.cc_inside, s.rule_2_query.projection);
+                exporter_->steiner_point_ = s.steiner_point;
+                exporter_->export_svg("iteration_" + std::to_string(iteration_), ITERATION_RULE);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    template<class Policy>
+    typename Policy::Queue &alpha_wrap_2::queue() {
+        return *std::get_if<typename Policy::Queue>(&queue_);
+    }
+
+    template<class Policy>
+    bool alpha_wrap_2::pop_gate(Gate &g) {
+        auto &queue = this->queue<Policy>();
+        gate_processing_timer_->start();
+        while (!queue.empty()) {
+            g = queue.top();
+            queue.pop();
+            if (refresh_gate(g)) {
+                gate_processing_timer_->pause();
+                return true;
+            }
+            statistics_.execution_stats.n_stale_gates_skipped++;
+        }
+        gate_processing_timer_->pause();
+        return false;
+    }
+
+    bool alpha_wrap_2::refresh_gate(Gate &g) const {
+        Delaunay::Face_handle f;
+        int i;
+        if (!dt_.is_edge(g.key.source, g.key.target, f, i)) {
+            return false;
+        }
+
+        // orient such that the inside face is first
+        if (f->vertex(i) != g.key.apex_inside) {
+            const auto mirror = dt_.mirror_edge(Delaunay::Edge(f, i));
+            f = mirror.first;
+            i = mirror.second;
+        }
+
+        // one of the adjacent faces was destroyed since the gate was queued
+        if (f->vertex(i) != g.key.apex_inside || dt_.mirror_vertex(f, i) != g.key.apex_outside) {
+            return false;
+        }
+
+        // the faces are unchanged, but the inside face might have been carved in the meantime
+        g.edge = Delaunay::Edge(f, i);
+        return f->info() == INSIDE && f->neighbor(i)->info() == OUTSIDE;
+    }
+
     EdgeAdjacencyInfo alpha_wrap_2::gate_adjacency_info(const Delaunay::Edge &edge) const {
         EdgeAdjacencyInfo info;
         info.edge = edge;
@@ -233,32 +705,41 @@ namespace aw2 {
             throw std::runtime_error("Error: c_in is infinite face.");
         }
 
-        info.cc_inside = dt_.circumcenter(c_in);
+        info.cc_inside = c_in->cached_circumcenter();
+        info.outside_infinite = dt_.is_infinite(c_out);
+        info.cc_outside = c_out->cached_circumcenter();
+
+        return info;
+    }
 
-        if (dt_.is_infinite(c_out)) {
-            info.outside_infinite = true;
-            info.cc_outside = infinite_face_cc(c_in, c_out, i);
+    void alpha_wrap_2::cache_face_geometry(const Delaunay::Face_handle &f) {
+        if (dt_.is_infinite(f)) {
+            // the circumcenter of an infinite face depends on its finite edge and the side of the finite neighbor
+            const auto c_in = f->neighbor(f->index(dt_.infinite_vertex()));
+            const int i = c_in->index(f);
+            const auto cc = infinite_face_cc(c_in, f, i);
+            f->set_cached_circumcenter(cc, CGAL::squared_distance(cc, c_in->vertex(Delaunay::cw(i))->point()));
         } else {
-            info.outside_infinite = false;
-            info.cc_outside = dt_.circumcenter(c_out);
+            const auto cc = dt_.circumcenter(f);
+            f->set_cached_circumcenter(cc, CGAL::squared_distance(cc, f->vertex(0)->point()));
         }
-
-        return info;
     }
 
 
     // Return the squared radius of the minimal Delaunay ball through the edge
+    template<class Policy>
     FT alpha_wrap_2::sq_minimal_delaunay_ball_radius(const Gate &gate) const {
-        auto [edge, cc_inside, cc_outside, outside_infinite] = gate_adjacency_info(gate.edge);
+        const auto &cc_inside = gate.cc_inside;
+        const auto &cc_outside = gate.cc_outside;
         const auto p1 = gate.get_points().first;
         const auto p2 = gate.get_points().second;
         const auto min_ball_center = CGAL::midpoint(p1, p2);
         auto sq_min_ball_radius = CGAL::squared_distance(p1, p2) / 4;
 
-        auto sq_inside_ball_radius = CGAL::squared_distance(cc_inside, p1);
+        auto sq_inside_ball_radius = gate.edge.first->cached_sq_radius();
 
         // INFINITE outer cell
-        if (outside_infinite) {
+        if (gate.outside_infinite) {
             if (CGAL::squared_distance(cc_inside, min_ball_center) < sq_min_ball_radius) {
                 return sq_inside_ball_radius;
             }
@@ -273,26 +754,27 @@ namespace aw2 {
         }
 
         // Case 2: minimum ball is not Delaunay
-        auto sq_outside_ball_radius = CGAL::squared_distance(cc_outside, p1);
+        auto sq_outside_ball_radius = gate.edge.first->neighbor(gate.edge.second)->cached_sq_radius();
 
-#ifdef MODIFIED_ALPHA_TRAVERSABILITY
-        // Case 2.1: r_in > r_out
-        if (sq_outside_ball_radius < sq_inside_ball_radius) {
-            return sq_min_ball_radius;
-        }
+        if constexpr (Policy::modified_alpha_traversability) {
+            // Case 2.1: r_in > r_out
+            if (sq_outside_ball_radius < sq_inside_ball_radius) {
+                return sq_min_ball_radius;
+            }
 
-        // Case 2.2: r_in <= r_out
-        return sq_inside_ball_radius;
-#else
-        return std::min(sq_inside_ball_radius, sq_outside_ball_radius);
-#endif
+            // Case 2.2: r_in <= r_out
+            return sq_inside_ball_radius;
+        } else {
+            return std::min(sq_inside_ball_radius, sq_outside_ball_radius);
+        }
     }
 
+    template<class Policy>
     void alpha_wrap_2::update_queue(const Delaunay::Face_handle &fh) {
         gate_processing_timer_->start();
         for (int i = 0; i < 3; ++i) {
             Delaunay::Edge e(fh, i);
-            add_gate_to_queue(e);
+            add_gate_to_queue<Policy>(e);
         }
         gate_processing_timer_->pause();
     }
@@ -320,9 +802,16 @@ namespace aw2 {
         return CGAL::circumcenter(p1, p2, far_point);
     }
 
-    bool alpha_wrap_2::process_rule_1(const Point_2 &c_in_cc, const Point_2 &c_out_cc) {
+    bool alpha_wrap_2::process_rule_1(const Delaunay::Edge &gate_edge, const Point_2 &c_in_cc,
+                                      const Point_2 &c_out_cc, Point_2 &steiner_point) {
+        // the segment is the same as long as both faces are unchanged
+        const auto &c_in = gate_edge.first;
+        if (c_in->rule_1_negative(gate_edge.second)) {
+            statistics_.execution_stats.n_rule_1_calls_avoided++;
+            return false;
+        }
+
         rule1_timer_->start();
-        Point_2 steiner_point;
         const bool insert = oracle_.first_intersection(
             c_out_cc,
             c_in_cc,
@@ -336,68 +825,137 @@ namespace aw2 {
                 exporter_->steiner_point_ = steiner_point;
                 exporter_->export_svg("iteration_" + std::to_string(iteration_), ITERATION_RULE);
             }
-            insert_steiner_point(steiner_point);
             return true;
         }
+        c_in->set_rule_1_negative(gate_edge.second);
         rule1_timer_->pause();
         return false;
     }
 
-    bool alpha_wrap_2::process_rule_2(const Delaunay::Face_handle &c_in, const Point_2 &c_in_cc) {
+    bool alpha_wrap_2::process_rule_2(const Delaunay::Face_handle &c_in, const Point_2 &c_in_cc,
+                                      Point_2 &steiner_point) {
+        if (c_in->rule_2_negative()) {
+            statistics_.execution_stats.n_rule_2_calls_avoided++;
+            return false;
+        }
+
         rule2_timer_->start();
 
-        if (const auto c_in_triangle = dt_.triangle(c_in); oracle_.do_intersect(c_in_triangle)) {
-            Point_2 steiner_point;
-            // project circumcenter onto point set
-            const auto p_input = oracle_.closest_point(c_in_cc);
-
-            // insert intersection with offset surface as steiner point
-            const bool insert = oracle_.first_intersection(
-                c_in_cc,
-                p_input,
-                steiner_point,
-                offset_
-            );
-            if (insert) {
+        // occupancy, projection of the circumcenter and its intersection with the offset surface in one query
+        Rule2Query query;
+        const bool occupied = oracle_.rule_2_query(dt_.triangle(c_in), c_in_cc, offset_, query);
+        statistics_.execution_stats.n_rule_2_points_visited += query.n_visited;
+
+        if (occupied) {
+            if (query.intersects) {
                 rule2_timer_->pause();
                 if (export_step_) {
-                    exporter_->rule_segment_ = Segment_2(c_in_cc, p_input);
-                    exporter_->steiner_point_ = steiner_point;
+                    exporter_->rule_segment_ = Segment_2(c_in_cc, query.projection);
+                    exporter_->steiner_point_ = query.steiner_point;
                     exporter_->export_svg("iteration_" + std::to_string(iteration_), ITERATION_RULE);
                 }
-                insert_steiner_point(steiner_point);
+                steiner_point = query.steiner_point;
                 return true;
             }
             throw std::runtime_error("Error: R2 failed to compute intersection point.");
         }
+        c_in->set_rule_2_negative();
         rule2_timer_->pause();
         return false;
     }
 
-    void alpha_wrap_2::insert_steiner_point(const Point_2 &steiner_point) {
-        // insert Steiner point
-        const auto vh = dt_.insert(steiner_point);
+    template<class Policy>
+    void alpha_wrap_2::insert_steiner_point(const Point_2 &steiner_point, const Delaunay::Face_handle &hint) {
+        // both rules place the point on the segment between the circumcenters of the gate faces or in the
+        // circumcircle of the inside face, so the walk from c_in usually only crosses a few faces
+        const auto vh = insert_vertex(steiner_point, hint);
 
-        // Update face labels
+        gate_processing_timer_->start();
+        if (config_.queue_update_mode == INCREMENTAL) {
+            repair_queue<Policy>(vh);
+        } else {
+            rebuild_queue<Policy>();
+        }
+        gate_processing_timer_->pause();
+    }
+
+    Delaunay::Vertex_handle alpha_wrap_2::insert_vertex(const Point_2 &steiner_point,
+                                                        const Delaunay::Face_handle &hint) {
+        const auto vh = dt_.insert(steiner_point, hint);
+
+        // Update face labels, all faces which were created or changed by the insertion are incident to vh.
+        // The faces across their edge opposite to vh survived the insertion with a new neighbor.
         for (auto fit = dt_.incident_faces(vh); ;) {
             if (dt_.is_infinite(fit)) {
                 fit->info() = OUTSIDE;
             } else {
                 fit->info() = INSIDE;
             }
+            cache_face_geometry(fit);
+            fit->reset_rules();
+            const auto n = fit->neighbor(fit->index(vh));
+            n->reset_rule_1(n->index(fit));
             if (++fit == dt_.incident_faces(vh)) break;
         }
+        return vh;
+    }
 
-        gate_processing_timer_->start();
-        // clear the queue
-        Queue empty;
-        std::swap(queue_, empty);
+    template<class Policy>
+    void alpha_wrap_2::rebuild_queue() {
+        auto &queue = this->queue<Policy>();
+        queue.clear();
 
-        // Add new gates to the queue
+        if (!thread_pool_) {
+            for (auto eit = dt_.all_edges_begin(); eit != dt_.all_edges_end(); ++eit) {
+                add_gate_to_queue<Policy>(*eit);
+            }
+            return;
+        }
+
+        rebuild_edges_.clear();
         for (auto eit = dt_.all_edges_begin(); eit != dt_.all_edges_end(); ++eit) {
-            add_gate_to_queue(*eit);
+            if (is_gate(*eit)) rebuild_edges_.push_back(*eit);
         }
-        gate_processing_timer_->pause();
+
+        // Gates are evaluated in parallel in contiguous chunks, each chunk into its own buffer. The buffers are
+        // pushed in edge order, so the queue is the same as with a single thread.
+        const std::size_t n_edges = rebuild_edges_.size();
+        const std::size_t n_chunks = std::min<std::size_t>(4 * thread_pool_->size(), (n_edges + 63) / 64);
+        const std::size_t chunk_size = n_chunks > 0 ? (n_edges + n_chunks - 1) / n_chunks : 0;
+        rebuild_gates_.resize(std::max(rebuild_gates_.size(), n_chunks));
+
+        thread_pool_->parallel_for(n_chunks, [&](const std::size_t chunk) {
+            auto &gates = rebuild_gates_[chunk];
+            gates.clear();
+            const std::size_t end = std::min(n_edges, (chunk + 1) * chunk_size);
+            for (std::size_t i = chunk * chunk_size; i < end; ++i) {
+                Gate g;
+                if (evaluate_gate<Policy>(rebuild_edges_[i], g)) {
+                    gates.push_back(g);
+                }
+            }
+        });
+
+        for (std::size_t chunk = 0; chunk < n_chunks; ++chunk) {
+            for (const auto &g: rebuild_gates_[chunk]) {
+                if (queue.push(g)) statistics_.execution_stats.n_gates_queued++;
+            }
+        }
+    }
+
+    template<class Policy>
+    void alpha_wrap_2::repair_queue(const Delaunay::Vertex_handle &vh) {
+        // Queued gates which touch the conflict zone of vh are stale now, they are dropped once they reach
+        // the top of the queue. Only the edges of the new faces need to be evaluated.
+        // Every face in the star of vh contributes its edge opposite to vh (the boundary of the conflict zone)
+        // and one of its edges incident to vh, so each edge is visited once.
+        auto fit = dt_.incident_faces(vh);
+        const auto done = fit;
+        do {
+            const int i = fit->index(vh);
+            add_gate_to_queue<Policy>(Delaunay::Edge(fit, i));
+            add_gate_to_queue<Policy>(Delaunay::Edge(fit, Delaunay::ccw(i)));
+        } while (++fit != done);
     }
 
     void alpha_wrap_2::extract_wrap_surface() {
@@ -411,20 +969,35 @@ namespace aw2 {
         }
     }
 
+    template<class Policy>
     void alpha_wrap_2::add_gate_to_queue(const Delaunay::Edge &edge) {
         if (!is_gate(edge)) return;
 
         Gate g;
+        if (evaluate_gate<Policy>(edge, g) && queue<Policy>().push(g)) {
+            statistics_.execution_stats.n_gates_queued++;
+        }
+    }
+
+    template<class Policy>
+    bool alpha_wrap_2::evaluate_gate(const Delaunay::Edge &edge, Gate &g) const {
         const auto f = edge.first;
 
         // orient such that INSIDE face is first
         g.edge = f->info() == INSIDE ? edge : dt_.mirror_edge(edge);
-        g.sq_min_delaunay_rad = sq_minimal_delaunay_ball_radius(g);
-
-        // add to queue if traversable
-        if ((*traversability_)(g)) {
-            queue_.push(g);
-        }
+        std::tie(g.key.source, g.key.target) = g.get_vertices();
+        g.key.apex_inside = g.edge.first->vertex(g.edge.second);
+        g.key.apex_outside = dt_.mirror_vertex(g.edge.first, g.edge.second);
+
+        const auto c_out = g.edge.first->neighbor(g.edge.second);
+        g.cc_inside = g.edge.first->cached_circumcenter();
+        g.cc_outside = c_out->cached_circumcenter();
+        g.outside_infinite = dt_.is_infinite(c_out);
+        g.sq_min_delaunay_rad = sq_minimal_delaunay_ball_radius<Policy>(g);
+
+        // only traversable gates are queued, the policy type is final (except for the dynamic baseline),
+        // so the call is resolved statically
+        return static_cast<typename Policy::Traversability &>(*traversability_)(g);
     }
 }
 
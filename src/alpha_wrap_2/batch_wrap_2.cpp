@@ -0,0 +1,217 @@
+#include "alpha_wrap_2/batch_wrap_2.h"
+#include "alpha_wrap_2/export_utils.h"
+#include "alpha_wrap_2/thread_pool.h"
+#include "alpha_wrap_2/timer.h"
+
+#include <glob.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+
+namespace aw2 {
+    namespace fs = std::filesystem;
+
+    namespace {
+        // nearest-rank percentile of sorted values
+        double percentile(const std::vector<double> &sorted, const double p) {
+            if (sorted.empty()) return 0.0;
+            const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+            return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+        }
+    }
+
+    std::vector<std::string> read_manifest(const std::string &manifest) {
+        std::vector<std::string> files;
+        std::error_code ec;
+
+        if (fs::is_directory(manifest, ec)) {
+            for (const auto &entry: fs::directory_iterator(manifest, ec)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".pts") {
+                    files.push_back(entry.path().string());
+                }
+            }
+            if (ec) {
+                throw std::invalid_argument("Failed to list the directory " + manifest + ": " + ec.message());
+            }
+            std::sort(files.begin(), files.end());
+        } else if (fs::path(manifest).extension() == ".json" && fs::is_regular_file(manifest, ec)) {
+            std::ifstream input(manifest);
+            nlohmann::json list;
+            try {
+                input >> list;
+            } catch (const nlohmann::json::exception &e) {
+                throw std::invalid_argument("Failed to parse the manifest " + manifest + ": " + e.what());
+            }
+            if (!list.is_array()) {
+                throw std::invalid_argument("The manifest " + manifest + " has to be a JSON array of paths.");
+            }
+            const fs::path base = fs::path(manifest).parent_path();
+            for (const auto &item: list) {
+                if (!item.is_string()) {
+                    throw std::invalid_argument("The manifest " + manifest + " has to be a JSON array of paths.");
+                }
+                const fs::path path(item.get<std::string>());
+                files.push_back((path.is_absolute() ? path : base / path).string());
+            }
+        } else {
+            glob_t matches;
+            const int result = ::glob(manifest.c_str(), 0, nullptr, &matches);
+            if (result == 0) {
+                for (std::size_t i = 0; i < matches.gl_pathc; ++i) {
+                    if (fs::is_regular_file(matches.gl_pathv[i], ec)) files.emplace_back(matches.gl_pathv[i]);
+                }
+            }
+            ::globfree(&matches);
+            if (result != 0 && result != GLOB_NOMATCH) {
+                throw std::invalid_argument("Failed to expand the pattern " + manifest + ".");
+            }
+        }
+
+        if (files.empty()) {
+            throw std::invalid_argument("The manifest " + manifest + " lists no input files.");
+        }
+        return files;
+    }
+
+    void batch_wrap_2::run(const std::vector<std::string> &files, const AlgorithmConfig &config,
+                           const BatchConfig &batch) {
+        Timer total_timer("Batch Wrap");
+        total_timer.start();
+
+        // one output directory per file, named after it unless the name is taken by another file
+        std::map<std::string, int> name_count;
+        for (const auto &file: files) {
+            ++name_count[fs::path(file).stem().string()];
+        }
+        statistics_.files.assign(files.size(), BatchFileStats());
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            auto &file = statistics_.files[i];
+            std::string name = fs::path(files[i]).stem().string();
+            if (name_count[name] > 1) name += "_" + std::to_string(i);
+            file.input_file = files[i];
+            file.output_directory = (fs::path(config.output_directory) / name).string();
+        }
+
+        // largest files first, the pool hands out the next file to whichever thread is done
+        std::vector<std::uintmax_t> sizes(files.size(), 0);
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            std::error_code ec;
+            if (const auto size = fs::file_size(files[i], ec); !ec) sizes[i] = size;
+        }
+        std::vector<std::size_t> order(files.size());
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&](const std::size_t a, const std::size_t b) {
+            return sizes[a] > sizes[b];
+        });
+
+        ThreadPool pool(static_cast<unsigned>(std::max(0, batch.n_threads)));
+        BatchConfig file_batch = batch;
+        if (file_batch.memory_budget > 0) {
+            file_batch.memory_budget = std::max<std::size_t>(1, batch.memory_budget / pool.size());
+        }
+        pool.parallel_for(order.size(), [&](const std::size_t i) {
+            wrap_file(statistics_.files[order[i]], config, file_batch);
+        });
+
+        total_timer.pause();
+
+        // Collect statistics
+        fill_config_stats(config, statistics_.config);
+        statistics_.config.n_threads = static_cast<int>(pool.size());
+        statistics_.config.point_order = point_order_name(batch.point_order);
+
+        std::vector<double> latencies;
+        statistics_.n_files = static_cast<int>(files.size());
+        statistics_.n_failed = 0;
+        statistics_.n_points = 0;
+        for (const auto &file: statistics_.files) {
+            if (!file.ok) {
+                ++statistics_.n_failed;
+                continue;
+            }
+            statistics_.n_points += file.n_input_points;
+            latencies.push_back(file.latency);
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        statistics_.total_time = total_timer.elapsed_ms();
+        const double seconds = statistics_.total_time / 1000.0;
+        statistics_.files_per_second = seconds > 0 ? statistics_.n_files / seconds : 0.0;
+        statistics_.points_per_second = seconds > 0 ? static_cast<double>(statistics_.n_points) / seconds : 0.0;
+        statistics_.latency_p50 = percentile(latencies, 0.5);
+        statistics_.latency_p99 = percentile(latencies, 0.99);
+
+        try {
+            fs::create_directories(config.output_directory);
+        } catch (const fs::filesystem_error &e) {
+            throw std::runtime_error("Failed to create directory: " + std::string(e.what()));
+        }
+        statistics_.export_to_json((fs::path(config.output_directory) / "batch_summary.json").string());
+    }
+
+    void batch_wrap_2::wrap_file(BatchFileStats &file, const AlgorithmConfig &config,
+                                 const BatchConfig &batch) const {
+        Timer latency_timer("File Latency");
+        Timer reorder_timer("Point Reordering");
+        latency_timer.start();
+
+        try {
+            Points points = Oracle::read_points(file.input_file);
+            if (points.empty()) {
+                throw std::invalid_argument("No points read from " + file.input_file + ".");
+            }
+            reorder_timer.start();
+            reorder_points(points, batch.point_order);
+            reorder_timer.pause();
+
+            Oracle oracle;
+            oracle.add_point_set(points);
+            Points().swap(points);
+            if (!(oracle.bbox_diagonal_length() > 0)) {
+                throw std::invalid_argument("The bounding box of " + file.input_file + " is a single point.");
+            }
+
+            OracleParams params;
+            params.alpha = config.alpha * oracle.bbox_diagonal_length();
+            params.offset = config.offset * oracle.bbox_diagonal_length();
+            params.memory_budget = batch.memory_budget;
+            params.verify = batch.verify;
+            oracle.prepare(params);
+            if (batch.local_field) {
+                oracle.build_local_geometry_field(params);
+            }
+
+            // the files are the unit of parallelism
+            AlgorithmConfig file_config = config;
+            file_config.output_directory = file.output_directory;
+            file_config.n_threads = 1;
+            file_config.print_report = false;
+
+            alpha_wrap_2 aw(oracle);
+            aw.statistics_.config.input_file = file.input_file;
+            aw.statistics_.config.point_order = point_order_name(batch.point_order);
+            aw.statistics_.timings.point_reordering = reorder_timer.elapsed_ms();
+            aw.init(file_config);
+            aw.run();
+            export_wrap_edges(aw.wrap_edges_, (fs::path(file.output_directory) / "wrap_edges.txt").string());
+
+            const auto &stats = aw.get_statistics();
+            file.n_input_points = static_cast<int>(oracle.size());
+            file.n_iterations = stats.execution_stats.n_iterations;
+            file.n_edges = static_cast<int>(aw.wrap_edges_.size());
+            file.ok = true;
+        } catch (const std::exception &e) {
+            file.ok = false;
+            file.error = e.what();
+        }
+
+        latency_timer.pause();
+        file.latency = latency_timer.elapsed_ms();
+    }
+}
@@ -0,0 +1,219 @@
+#include "alpha_wrap_2/component_wrap_2.h"
+#include "alpha_wrap_2/export_utils.h"
+#include "alpha_wrap_2/thread_pool.h"
+#include "alpha_wrap_2/timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace aw2 {
+    namespace fs = std::filesystem;
+
+    std::vector<Points> offset_connected_components(const point_set_oracle_2 &oracle, const FT distance) {
+        if (!(distance > 0)) {
+            throw std::invalid_argument("The component distance has to be positive.");
+        }
+        std::vector<Points> components;
+        if (oracle.empty()) return components;
+
+        // the points of a cell are at most distance apart, connected cells are at most two cells apart
+        const FT cell_size = distance / std::sqrt(FT(2));
+        const auto &bbox = oracle.bbox_;
+        const auto ny = static_cast<std::int64_t>((bbox.y_max - bbox.y_min) / cell_size) + 1;
+        const auto key = [&](const std::int64_t ix, const std::int64_t iy) { return ix * ny + iy; };
+
+        std::vector<std::pair<std::int64_t, Point_2> > points;
+        points.reserve(oracle.size());
+        for (const auto &p: oracle.tree_) {
+            points.emplace_back(key(static_cast<std::int64_t>((p.x() - bbox.x_min) / cell_size),
+                                    static_cast<std::int64_t>((p.y() - bbox.y_min) / cell_size)), p);
+        }
+        std::sort(points.begin(), points.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+        // cells as ranges of the sorted points
+        std::vector<std::size_t> cell_begin;
+        std::unordered_map<std::int64_t, std::size_t> cell_index;
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            if (i == 0 || points[i].first != points[i - 1].first) {
+                cell_index.emplace(points[i].first, cell_begin.size());
+                cell_begin.push_back(i);
+            }
+        }
+        const std::size_t n_cells = cell_begin.size();
+        cell_begin.push_back(points.size());
+
+        std::vector<std::size_t> parent(n_cells);
+        std::iota(parent.begin(), parent.end(), std::size_t(0));
+        const auto find = [&](std::size_t c) {
+            while (parent[c] != c) {
+                parent[c] = parent[parent[c]];
+                c = parent[c];
+            }
+            return c;
+        };
+
+        // the exact test is skipped for large pairs of cells, they are joined
+        constexpr std::size_t max_pairs = 4096;
+        const FT sq_distance = distance * distance;
+        const auto close = [&](const std::size_t a, const std::size_t b) {
+            if ((cell_begin[a + 1] - cell_begin[a]) * (cell_begin[b + 1] - cell_begin[b]) > max_pairs) return true;
+            for (std::size_t i = cell_begin[a]; i < cell_begin[a + 1]; ++i) {
+                for (std::size_t j = cell_begin[b]; j < cell_begin[b + 1]; ++j) {
+                    if (CGAL::squared_distance(points[i].second, points[j].second) <= sq_distance) return true;
+                }
+            }
+            return false;
+        };
+
+        for (std::size_t c = 0; c < n_cells; ++c) {
+            const std::int64_t ix = points[cell_begin[c]].first / ny, iy = points[cell_begin[c]].first % ny;
+            // every pair of cells once
+            for (std::int64_t dx = 0; dx <= 2; ++dx) {
+                for (std::int64_t dy = -2; dy <= 2; ++dy) {
+                    if (dx == 0 && dy <= 0) continue;
+                    if (iy + dy < 0 || iy + dy >= ny) continue;
+                    const auto it = cell_index.find(key(ix + dx, iy + dy));
+                    if (it == cell_index.end()) continue;
+                    const std::size_t ra = find(c), rb = find(it->second);
+                    if (ra != rb && close(c, it->second)) parent[rb] = ra;
+                }
+            }
+        }
+
+        std::unordered_map<std::size_t, std::size_t> component_index;
+        for (std::size_t c = 0; c < n_cells; ++c) {
+            const auto [it, inserted] = component_index.try_emplace(find(c), components.size());
+            if (inserted) components.emplace_back();
+            auto &component = components[it->second];
+            for (std::size_t i = cell_begin[c]; i < cell_begin[c + 1]; ++i) {
+                component.push_back(points[i].second);
+            }
+        }
+        std::stable_sort(components.begin(), components.end(), [](const Points &a, const Points &b) {
+            return a.size() > b.size();
+        });
+        return components;
+    }
+
+    component_wrap_2::component_wrap_2(const Oracle &oracle) : oracle_(oracle) {
+    }
+
+    void component_wrap_2::run(const AlgorithmConfig &config, const OracleParams &params, const bool local_field) {
+        Timer total_timer("Component Wrap");
+        Timer clustering_timer("Clustering");
+        total_timer.start();
+
+        if (oracle_.empty()) {
+            throw std::invalid_argument("Cannot wrap the components of an empty input.");
+        }
+
+        const FT diag = oracle_.bbox_diagonal_length();
+        const FT alpha = config.alpha * diag;
+        const FT offset = config.offset * diag;
+        local_field_ = local_field;
+
+        // points up to 2 * (alpha + offset) apart are too close for a ball of radius alpha to pass between their
+        // offset surfaces
+        clustering_timer.start();
+        std::vector<Component> components;
+        for (auto &points: offset_connected_components(oracle_, 2 * (alpha + offset))) {
+            components.emplace_back();
+            components.back().points = std::move(points);
+        }
+        clustering_timer.pause();
+
+        // a single component is wrapped as well, the result is the one of a monolithic run
+        if (components.size() > 1) {
+            reachability_.build(oracle_, (alpha + offset) / 2, params.memory_budget);
+        }
+
+        ThreadPool pool(static_cast<unsigned>(std::max(0, config.n_threads)));
+        OracleParams component_params = params;
+        if (component_params.memory_budget > 0) {
+            component_params.memory_budget = std::max<std::size_t>(1, params.memory_budget / pool.size());
+        }
+        pool.parallel_for(components.size(), [&](const std::size_t i) {
+            wrap_component(components[i], config, component_params);
+        });
+
+        wrap_edges_.clear();
+        statistics_.n_enclosed_components = 0;
+        statistics_.components.clear();
+        for (const auto &component: components) {
+            wrap_edges_.insert(wrap_edges_.end(), component.edges.begin(), component.edges.end());
+            statistics_.n_enclosed_components += component.stats.enclosed;
+            statistics_.components.push_back(component.stats);
+        }
+
+        total_timer.pause();
+
+        // Collect statistics, the configuration is the one of the whole input
+        fill_config_stats(config, statistics_.config);
+        statistics_.config.n_threads = static_cast<int>(pool.size());
+
+        statistics_.separation = 2 * (alpha + offset);
+        statistics_.n_components = static_cast<int>(components.size());
+        statistics_.reachability_cell_size = reachability_.cell_size();
+        statistics_.n_edges = static_cast<int>(wrap_edges_.size());
+        statistics_.total_time = total_timer.elapsed_ms();
+        statistics_.clustering_time = clustering_timer.elapsed_ms();
+
+        try {
+            fs::create_directories(config.output_directory);
+        } catch (const fs::filesystem_error &e) {
+            throw std::runtime_error("Failed to create directory: " + std::string(e.what()));
+        }
+        export_wrap_edges(wrap_edges_, (fs::path(config.output_directory) / "wrap_edges.txt").string());
+        statistics_.export_to_json((fs::path(config.output_directory) / "statistics.json").string());
+    }
+
+    void component_wrap_2::wrap_component(Component &component, const AlgorithmConfig &config,
+                                          const OracleParams &params) const {
+        component.stats.n_input_points = static_cast<int>(component.points.size());
+
+        Timer oracle_timer("Component Oracle");
+        oracle_timer.start();
+        Oracle oracle;
+        oracle.add_point_set(component.points);
+        Points().swap(component.points);
+        // grown by the offset, so that single points and collinear components have a bounding box of positive size
+        oracle.bbox_.x_min -= params.offset;
+        oracle.bbox_.x_max += params.offset;
+        oracle.bbox_.y_min -= params.offset;
+        oracle.bbox_.y_max += params.offset;
+        oracle.prepare(params);
+        if (local_field_) {
+            oracle.build_local_geometry_field(params);
+        }
+        oracle_timer.pause();
+        component.stats.oracle_time = oracle_timer.elapsed_ms();
+
+        // the relative parameters refer to the bounding box of the component, rescale them to keep the absolute
+        // values; components are the unit of parallelism and are not exported individually
+        AlgorithmConfig component_config = rescaled_config(
+            config, oracle_.bbox_diagonal_length() / oracle.bbox_diagonal_length());
+        component_config.n_threads = 1;
+        component_config.export_step_limit = 0;
+        component_config.export_results = false;
+        component_config.print_report = false;
+
+        alpha_wrap_2 aw(oracle);
+        aw.init(component_config);
+        aw.run();
+
+        component.stats.enclosed = reachability_.is_enclosed(aw.dt_);
+        if (!component.stats.enclosed) {
+            component.edges = aw.wrap_edges_;
+        }
+
+        const auto &stats = aw.get_statistics();
+        component.stats.n_iterations = stats.execution_stats.n_iterations;
+        component.stats.n_edges = static_cast<int>(component.edges.size());
+        component.stats.total_time = stats.timings.total_time;
+    }
+}
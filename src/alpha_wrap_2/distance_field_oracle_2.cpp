@@ -0,0 +1,265 @@
+#include <alpha_wrap_2/distance_field_oracle_2.h>
+
+#include <cmath>
+#include <limits>
+
+namespace aw2 {
+    void distance_field_oracle_2::prepare(const OracleParams &params) {
+        point_set_oracle_2::prepare(params);
+
+        offset_ = params.offset;
+        verify_ = params.verify;
+        tiles_.clear();
+        samples_.clear();
+        if (tree_.empty() || offset_ <= 0.0) return;
+
+        x_min_ = y_min_ = std::numeric_limits<FT>::infinity();
+        x_max_ = y_max_ = -std::numeric_limits<FT>::infinity();
+        for (const auto &pt: tree_) {
+            x_min_ = std::min(x_min_, pt.x());
+            x_max_ = std::max(x_max_, pt.x());
+            y_min_ = std::min(y_min_, pt.y());
+            y_max_ = std::max(y_max_, pt.y());
+        }
+
+        // start with two samples per offset and coarsen until the samples fit into the budget
+        FT resolution = 0.5 * offset_;
+        std::size_t n_bytes = layout(resolution);
+        while (params.memory_budget > 0 && n_bytes > params.memory_budget) {
+            // coarsening a single tile does not save memory, the queries stay exact without a field
+            if (tiles_.size() == 1) {
+                tiles_.clear();
+                resolution_ = 0.0;
+                return;
+            }
+            resolution *= 2.0;
+            n_bytes = layout(resolution);
+        }
+        rasterize();
+    }
+
+    std::size_t distance_field_oracle_2::layout(const FT resolution) {
+        resolution_ = resolution;
+        inv_resolution_ = 1.0 / resolution;
+        // the distance is 1-Lipschitz, so interpolating the samples of a cell is off by at most its diagonal,
+        // with some slack for the float samples
+        error_ = 1.01 * std::sqrt(2.0) * resolution;
+        band_ = 3.0 * error_;
+
+        const FT margin = offset_ + band_ + resolution;
+        x0_ = x_min_ - margin;
+        y0_ = y_min_ - margin;
+        const FT tile_extent = tile_size * resolution;
+        n_tiles_x_ = std::max(1, static_cast<int>(std::ceil((x_max_ - x_min_ + 2 * margin) / tile_extent)));
+        n_tiles_y_ = std::max(1, static_cast<int>(std::ceil((y_max_ - y_min_ + 2 * margin) / tile_extent)));
+
+        tiles_.assign(static_cast<std::size_t>(n_tiles_x_) * n_tiles_y_, Tile{0.0f, no_samples});
+        const FT half_diagonal = 0.5 * std::sqrt(2.0) * tile_extent;
+        std::size_t n_sampled = 0;
+        for (int ty = 0; ty < n_tiles_y_; ++ty) {
+            for (int tx = 0; tx < n_tiles_x_; ++tx) {
+                const Point_2 center(x0_ + (tx + 0.5) * tile_extent, y0_ + (ty + 0.5) * tile_extent);
+                const FT bound = std::max<FT>(
+                    0.0, std::sqrt(point_set_oracle_2::squared_distance(center)) - half_diagonal);
+
+                // round down to stay a lower bound
+                float lower_bound = static_cast<float>(bound);
+                if (lower_bound > bound) lower_bound = std::nextafter(lower_bound, 0.0f);
+                tiles_[static_cast<std::size_t>(ty) * n_tiles_x_ + tx].lower_bound = lower_bound;
+
+                if (bound <= offset_ + band_) ++n_sampled;
+            }
+        }
+
+        return tiles_.size() * sizeof(Tile) + n_sampled * (tile_size + 1) * (tile_size + 1) * sizeof(float);
+    }
+
+    void distance_field_oracle_2::rasterize() {
+        for (int ty = 0; ty < n_tiles_y_; ++ty) {
+            for (int tx = 0; tx < n_tiles_x_; ++tx) {
+                auto &tile = tiles_[static_cast<std::size_t>(ty) * n_tiles_x_ + tx];
+                if (tile.lower_bound > offset_ + band_) continue;
+
+                tile.first_sample = samples_.size();
+                for (int j = 0; j <= tile_size; ++j) {
+                    for (int i = 0; i <= tile_size; ++i) {
+                        const Point_2 sample(x0_ + (tx * tile_size + i) * resolution_,
+                                             y0_ + (ty * tile_size + j) * resolution_);
+                        samples_.push_back(
+                            static_cast<float>(std::sqrt(point_set_oracle_2::squared_distance(sample))));
+                    }
+                }
+            }
+        }
+    }
+
+    FT distance_field_oracle_2::lower_bound(const Point_2 &p, FT &approx, bool &sampled) const {
+        sampled = false;
+
+        // the distance to the bounding box of the input is a lower bound everywhere
+        const FT dx = std::max({x_min_ - p.x(), FT(0), p.x() - x_max_});
+        const FT dy = std::max({y_min_ - p.y(), FT(0), p.y() - y_max_});
+        const FT box_bound = std::sqrt(dx * dx + dy * dy);
+
+        const FT fx = (p.x() - x0_) * inv_resolution_;
+        const FT fy = (p.y() - y0_) * inv_resolution_;
+        if (!(fx >= 0.0 && fy >= 0.0 && fx < n_tiles_x_ * tile_size && fy < n_tiles_y_ * tile_size)) {
+            return box_bound;
+        }
+
+        const int tx = std::min(static_cast<int>(fx) / tile_size, n_tiles_x_ - 1);
+        const int ty = std::min(static_cast<int>(fy) / tile_size, n_tiles_y_ - 1);
+        const auto &tile = tiles_[static_cast<std::size_t>(ty) * n_tiles_x_ + tx];
+        if (tile.first_sample == no_samples) {
+            return std::max<FT>(box_bound, tile.lower_bound);
+        }
+
+        // bilinear interpolation within the tile
+        const FT lx = std::clamp<FT>(fx - tx * tile_size, 0.0, tile_size);
+        const FT ly = std::clamp<FT>(fy - ty * tile_size, 0.0, tile_size);
+        const int i = std::min(static_cast<int>(lx), tile_size - 1);
+        const int j = std::min(static_cast<int>(ly), tile_size - 1);
+        const FT u = lx - i;
+        const FT v = ly - j;
+        const float *s = samples_.data() + tile.first_sample + j * (tile_size + 1) + i;
+        approx = (1 - v) * ((1 - u) * s[0] + u * s[1]) +
+                 v * ((1 - u) * s[tile_size + 1] + u * s[tile_size + 2]);
+        sampled = true;
+        return std::max(box_bound, approx - error_);
+    }
+
+    void distance_field_oracle_2::outside_offset(const std::vector<Point_2> &points, const FT offset_size,
+                                                 std::vector<bool> &outside) const {
+        // the field only describes the offset surface it was built for
+        if (!has_field() || offset_size != offset_) {
+            point_set_oracle_2::outside_offset(points, offset_size, outside);
+            return;
+        }
+
+        thread_local std::vector<Point_2> exact_points;
+        thread_local std::vector<std::size_t> exact_indices;
+        thread_local std::vector<FT> exact_sq_distances;
+        exact_points.clear();
+        exact_indices.clear();
+        outside.resize(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            bool side;
+            if (field_outside_offset(points[i], side)) {
+                outside[i] = side;
+            } else {
+                exact_points.push_back(points[i]);
+                exact_indices.push_back(i);
+            }
+        }
+
+        point_set_oracle_2::squared_distances(exact_points, exact_sq_distances);
+        const FT sq_offset = offset_ * offset_;
+        for (std::size_t j = 0; j < exact_indices.size(); ++j) {
+            outside[exact_indices[j]] = exact_sq_distances[j] >= sq_offset;
+        }
+    }
+
+    bool distance_field_oracle_2::field_outside_offset(const Point_2 &p, bool &outside) const {
+        FT approx = 0.0;
+        bool sampled;
+        const FT bound = lower_bound(p, approx, sampled);
+
+        // far from the offset surface the field decides on which side p is, only close to it the exact
+        // distance is needed
+        if (!sampled && bound > offset_ + band_) {
+            outside = true;
+        } else if (sampled && std::abs(approx - offset_) > 2.0 * error_) {
+            outside = approx > offset_;
+        } else {
+            return false;
+        }
+
+        if (verify_) {
+            const FT exact = point_set_oracle_2::squared_distance(p);
+            count_verified(outside != (exact >= offset_ * offset_));
+        }
+        return true;
+    }
+
+    bool distance_field_oracle_2::first_intersection(const Point_2 &p, const Point_2 &q,
+                                                     Point_2 &o,
+                                                     const FT offset_size,
+                                                     FT &lambda) const {
+        // the field only describes the offset surface it was built for
+        if (!has_field() || offset_size != offset_) {
+            return point_set_oracle_2::first_intersection(p, q, o, offset_size, lambda);
+        }
+
+        const bool intersects = field_first_intersection(p, q, o, offset_size, lambda);
+
+        if (verify_) {
+            Point_2 exact_o;
+            FT exact_lambda = 0.0;
+            const bool exact = point_set_oracle_2::first_intersection(p, q, exact_o, offset_size, exact_lambda);
+            const FT length = std::sqrt(CGAL::squared_distance(p, q));
+            count_verified(intersects != exact ||
+                           (exact && std::abs(lambda - exact_lambda) * length > 1e-6 * offset_size));
+        }
+        return intersects;
+    }
+
+    bool distance_field_oracle_2::first_intersection(const Point_2 &p, const Point_2 &q,
+                                                     Point_2 &o,
+                                                     const FT offset_size) const {
+        FT dump;
+        return first_intersection(p, q, o, offset_size, dump);
+    }
+
+    bool distance_field_oracle_2::field_first_intersection(const Point_2 &p, const Point_2 &q, Point_2 &o,
+                                                           const FT offset_size, FT &lambda) const {
+        const FT dx = q.x() - p.x();
+        const FT dy = q.y() - p.y();
+        const FT length = std::sqrt(dx * dx + dy * dy);
+        if (length == 0) return false; // degenerate segment
+
+        // Sphere tracing: no offset circle can be hit before the distance lower bound has dropped to the offset,
+        // so far from the surface the segment advances by the gap. Close to it the next short window of the
+        // segment is resolved with the exact queries.
+        FT t = 0.0;
+        while (t < 1.0) {
+            const Point_2 x(p.x() + t * dx, p.y() + t * dy);
+            FT approx;
+            bool sampled;
+            const FT gap = lower_bound(x, approx, sampled) - offset_size;
+            if (gap > band_) {
+                t += gap / length;
+                continue;
+            }
+
+            const FT t_end = std::min<FT>(1.0, t + 2.0 * band_ / length);
+            const Point_2 y = t_end == 1.0 ? q : Point_2(p.x() + t_end * dx, p.y() + t_end * dy);
+            Point_2 hit;
+            FT local;
+            if (point_set_oracle_2::first_intersection(x, y, hit, offset_size, local)) {
+                lambda = t + local * (t_end - t);
+                o = Point_2(p.x() + lambda * dx, p.y() + lambda * dy);
+                return true;
+            }
+            t = t_end;
+        }
+        return false;
+    }
+
+    void distance_field_oracle_2::count_verified(const bool mismatch) const {
+        n_verified_.fetch_add(1, std::memory_order_relaxed);
+        if (mismatch) n_mismatches_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    DistanceFieldStats distance_field_oracle_2::field_stats() const {
+        DistanceFieldStats stats;
+        stats.resolution = resolution_;
+        stats.n_tiles = tiles_.size();
+        for (const auto &tile: tiles_) {
+            if (tile.first_sample != no_samples) ++stats.n_allocated_tiles;
+        }
+        stats.memory_bytes = tiles_.size() * sizeof(Tile) + samples_.size() * sizeof(float);
+        stats.n_verified = n_verified_.load();
+        stats.n_mismatches = n_mismatches_.load();
+        return stats;
+    }
+}
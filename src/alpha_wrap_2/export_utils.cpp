@@ -130,16 +130,19 @@ namespace aw2 {
         // Draw queue edges with priority-based coloring
         if (style_.draw_queue_edges) {
             ColorMap priority_colormap(RGBColor("#08fa00"), RGBColor("#ff1100"), 0, 500);
-            Queue temp_queue = wrapper_.queue_;
             os << "  <g fill=\"none\">\n";
-            while (!temp_queue.empty()) {
-                auto gate = temp_queue.top();
-                temp_queue.pop();
-                auto edge_color = style_.queue_edges.color;
-                auto sv1 = to_svg(gate.get_points().first);
-                auto sv2 = to_svg(gate.get_points().second);
-                draw_line(os, sv1, sv2, edge_color, stroke_width_ * style_.queue_edges.relative_stroke_width);
-            }
+            std::visit([&](auto temp_queue) {
+                while (!temp_queue.empty()) {
+                    auto gate = temp_queue.top();
+                    temp_queue.pop();
+                    // lazy deletion leaves entries whose edge was destroyed or is no longer a gate
+                    if (!wrapper_.refresh_gate(gate)) continue;
+                    auto edge_color = style_.queue_edges.color;
+                    auto sv1 = to_svg(gate.get_points().first);
+                    auto sv2 = to_svg(gate.get_points().second);
+                    draw_line(os, sv1, sv2, edge_color, stroke_width_ * style_.queue_edges.relative_stroke_width);
+                }
+            }, wrapper_.queue_);
             os << "  </g>\n";
         }
 
@@ -476,4 +479,16 @@ namespace aw2 {
                                                        int face_index) const {
         return (is_inside ? "insideGradient_" : "outsideGradient_") + std::to_string(face_index);
     }
+
+    void export_wrap_edges(const std::vector<Segment_2> &edges, const std::string &filepath) {
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file for writing: " + filepath);
+        }
+
+        file.precision(17);
+        for (const auto &e: edges) {
+            file << e.source().x() << " " << e.source().y() << " " << e.target().x() << " " << e.target().y() << "\n";
+        }
+    }
 }
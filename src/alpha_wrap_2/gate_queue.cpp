@@ -0,0 +1,94 @@
+#include <alpha_wrap_2/gate_queue.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace aw2 {
+    std::size_t GateKeyHash::operator()(const GateKey &k) const {
+        const std::hash<const void *> h;
+        std::size_t seed = h(&*k.source);
+        for (const auto &vh: {k.target, k.apex_inside, k.apex_outside}) {
+            seed ^= h(&*vh) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
+
+    void BucketGateContainer::pop() {
+        auto &b = buckets_[top_];
+        b.pop_back();
+        --size_;
+        if (!b.empty()) return;
+
+        occupied_[top_ / 64] &= ~(std::uint64_t(1) << (top_ % 64));
+        if (size_ == 0) return;
+
+        // move down to the next non-empty bucket
+        for (std::size_t w = top_ / 64 + 1; w-- > 0;) {
+            if (occupied_[w]) {
+                top_ = 64 * w + 63 - static_cast<std::size_t>(__builtin_clzll(occupied_[w]));
+                return;
+            }
+        }
+    }
+
+    void BucketGateContainer::clear() {
+        for (std::size_t w = 0; w < occupied_.size(); ++w) {
+            for (auto bits = occupied_[w]; bits; bits &= bits - 1) {
+                buckets_[64 * w + static_cast<std::size_t>(__builtin_ctzll(bits))].clear();
+            }
+            occupied_[w] = 0;
+        }
+        top_ = 0;
+        size_ = 0;
+    }
+
+    void DaryGateHeap::push(const Gate &g) {
+        std::uint32_t slot;
+        if (free_slots_.empty()) {
+            slot = static_cast<std::uint32_t>(pool_.size());
+            pool_.push_back(g);
+        } else {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+            pool_[slot] = g;
+        }
+        heap_.push_back({g.sq_min_delaunay_rad, slot});
+        sift_up(heap_.size() - 1);
+    }
+
+    void DaryGateHeap::pop() {
+        free_slots_.push_back(heap_.front().slot);
+        heap_.front() = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty()) sift_down(0);
+    }
+
+    void DaryGateHeap::sift_up(std::size_t i) {
+        const Entry e = heap_[i];
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / 4;
+            if (!(heap_[parent].key < e.key)) break;
+            heap_[i] = heap_[parent];
+            i = parent;
+        }
+        heap_[i] = e;
+    }
+
+    void DaryGateHeap::sift_down(std::size_t i) {
+        const Entry e = heap_[i];
+        const std::size_t n = heap_.size();
+        for (;;) {
+            const std::size_t first = 4 * i + 1;
+            if (first >= n) break;
+            const std::size_t last = std::min(first + 4, n);
+            std::size_t best = first;
+            for (std::size_t c = first + 1; c < last; ++c) {
+                if (heap_[best].key < heap_[c].key) best = c;
+            }
+            if (!(e.key < heap_[best].key)) break;
+            heap_[i] = heap_[best];
+            i = best;
+        }
+        heap_[i] = e;
+    }
+}
@@ -0,0 +1,453 @@
+#include <alpha_wrap_2/grid_oracle_2.h>
+#include "query_utils.h"
+#include "segment_circle_kernel.h"
+
+#include <cmath>
+#include <limits>
+
+namespace aw2 {
+    void grid_oracle_2::prepare(const OracleParams &params) {
+        point_set_oracle_2::prepare(params);
+
+        // Cells slightly larger than the offset keep every offset query within the 3x3 neighborhood of a cell,
+        // for large alpha the cells grow so that the sub-segments of the adaptive traversabilities span few cells
+        FT cell_size = std::max(1.25 * params.offset, 0.25 * params.alpha);
+        if (cell_size <= 0.0) {
+            cell_size = bbox_diagonal_length() / 100.0;
+        }
+        build(cell_size);
+    }
+
+    void grid_oracle_2::build(FT cell_size) {
+        cell_start_.clear();
+        cell_xs_.clear();
+        cell_ys_.clear();
+        if (tree_.empty() || cell_size <= 0.0) return;
+
+        FT x_min = std::numeric_limits<FT>::infinity();
+        FT y_min = std::numeric_limits<FT>::infinity();
+        FT x_max = -std::numeric_limits<FT>::infinity();
+        FT y_max = -std::numeric_limits<FT>::infinity();
+        for (const auto &pt: tree_) {
+            x_min = std::min(x_min, pt.x());
+            x_max = std::max(x_max, pt.x());
+            y_min = std::min(y_min, pt.y());
+            y_max = std::max(y_max, pt.y());
+        }
+
+        // limit the number of cells relative to the number of points
+        const double max_cells = std::max<double>(1024.0, 4.0 * static_cast<double>(tree_.size()));
+        double n_cells = (std::floor((x_max - x_min) / cell_size) + 1) * (std::floor((y_max - y_min) / cell_size) + 1);
+        if (n_cells > max_cells) {
+            cell_size *= std::sqrt(n_cells / max_cells);
+        }
+
+        x0_ = x_min;
+        y0_ = y_min;
+        cell_size_ = cell_size;
+        inv_cell_size_ = 1.0 / cell_size;
+        nx_ = static_cast<int>(std::floor((x_max - x_min) * inv_cell_size_)) + 1;
+        ny_ = static_cast<int>(std::floor((y_max - y_min) * inv_cell_size_)) + 1;
+
+        // counting sort of the points by cell
+        cell_start_.assign(static_cast<std::size_t>(nx_) * ny_ + 1, 0);
+        for (const auto &pt: tree_) {
+            cell_start_[cell_index(cell_x(pt.x()), cell_y(pt.y())) + 1]++;
+        }
+        for (std::size_t i = 1; i < cell_start_.size(); ++i) {
+            cell_start_[i] += cell_start_[i - 1];
+        }
+
+        std::vector<std::size_t> fill(cell_start_.begin(), cell_start_.end() - 1);
+        cell_xs_.resize(tree_.size());
+        cell_ys_.resize(tree_.size());
+        for (const auto &pt: tree_) {
+            const auto i = fill[cell_index(cell_x(pt.x()), cell_y(pt.y()))]++;
+            cell_xs_[i] = pt.x();
+            cell_ys_[i] = pt.y();
+        }
+    }
+
+    int grid_oracle_2::cell_x(const FT x) const {
+        const auto ix = static_cast<int>(std::floor((x - x0_) * inv_cell_size_));
+        return std::clamp(ix, 0, nx_ - 1);
+    }
+
+    int grid_oracle_2::cell_y(const FT y) const {
+        const auto iy = static_cast<int>(std::floor((y - y0_) * inv_cell_size_));
+        return std::clamp(iy, 0, ny_ - 1);
+    }
+
+    bool grid_oracle_2::do_intersect(const K::Triangle_2 &t) const {
+        std::size_t n_visited;
+        return do_intersect(t, n_visited);
+    }
+
+    bool grid_oracle_2::do_intersect(const K::Triangle_2 &triangle, std::size_t &n_visited) const {
+        if (!has_grid()) return point_set_oracle_2::do_intersect(triangle, n_visited);
+
+        n_visited = 0;
+        if (triangle.is_degenerate()) return false;
+
+        const K::Triangle_2 t = triangle.orientation() == CGAL::COUNTERCLOCKWISE ? triangle : triangle.opposite();
+        const auto bbox = t.bbox();
+        const int ix0 = cell_x(bbox.xmin());
+        const int ix1 = cell_x(bbox.xmax());
+        const int iy0 = cell_y(bbox.ymin());
+        const int iy1 = cell_y(bbox.ymax());
+
+        for (int iy = iy0; iy <= iy1; ++iy) {
+            for (int ix = ix0; ix <= ix1; ++ix) {
+                const auto c = cell_index(ix, iy);
+                if (cell_start_[c] == cell_start_[c + 1]) continue;
+
+                // cells are padded since the rounded cell assignment may place a point slightly outside,
+                // the clamped last row and column are always scanned
+                const FT pad = cell_size_ * 1e-9;
+                const FT xmin = x0_ + ix * cell_size_ - pad;
+                const FT ymin = y0_ + iy * cell_size_ - pad;
+                const auto relation = ix == nx_ - 1 || iy == ny_ - 1
+                                          ? RectTriangleRelation::CROSSING
+                                          : classify_rect(t, xmin, xmin + cell_size_ + 2 * pad, ymin,
+                                                          ymin + cell_size_ + 2 * pad);
+                if (relation == RectTriangleRelation::OUTSIDE) continue;
+                if (relation == RectTriangleRelation::INSIDE) {
+                    ++n_visited;
+                    return true;
+                }
+
+                for (auto i = cell_start_[c]; i < cell_start_[c + 1]; ++i) {
+                    ++n_visited;
+                    if (t.has_on_bounded_side(cell_point(i))) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    bool grid_oracle_2::rule_2_query(const K::Triangle_2 &triangle, const Point_2 &c, const FT offset_size,
+                                     Rule2Query &result) const {
+        if (!has_grid()) return point_set_oracle_2::rule_2_query(triangle, c, offset_size, result);
+
+        result = Rule2Query();
+        if (triangle.is_degenerate()) return false;
+
+        const K::Triangle_2 t = triangle.orientation() == CGAL::COUNTERCLOCKWISE ? triangle : triangle.opposite();
+        const auto bbox = t.bbox();
+        const FT radius = rule_2_query_radius(t, c, offset_size);
+        const FT sq_radius = radius * radius;
+
+        thread_local std::vector<FT> xs, ys;
+        thread_local std::vector<std::size_t> deferred;
+        xs.clear();
+        ys.clear();
+        deferred.clear();
+
+        auto scan_cell = [&](const std::size_t cell, const bool test_occupancy) {
+            for (auto i = cell_start_[cell]; i < cell_start_[cell + 1]; ++i) {
+                ++result.n_visited;
+                if (test_occupancy && !result.occupied && t.has_on_bounded_side(cell_point(i))) {
+                    result.occupied = true;
+                }
+                const FT dx = cell_xs_[i] - c.x();
+                const FT dy = cell_ys_[i] - c.y();
+                if (dx * dx + dy * dy <= sq_radius) {
+                    xs.push_back(cell_xs_[i]);
+                    ys.push_back(cell_ys_[i]);
+                }
+            }
+        };
+
+        // cells overlapping the face first, classified as in do_intersect
+        const int tx0 = cell_x(bbox.xmin());
+        const int tx1 = cell_x(bbox.xmax());
+        const int ty0 = cell_y(bbox.ymin());
+        const int ty1 = cell_y(bbox.ymax());
+        for (int iy = ty0; iy <= ty1; ++iy) {
+            for (int ix = tx0; ix <= tx1; ++ix) {
+                const auto cell = cell_index(ix, iy);
+                if (cell_start_[cell] == cell_start_[cell + 1]) continue;
+
+                auto relation = RectTriangleRelation::CROSSING;
+                if (!result.occupied && ix != nx_ - 1 && iy != ny_ - 1) {
+                    const FT pad = cell_size_ * 1e-9;
+                    const FT xmin = x0_ + ix * cell_size_ - pad;
+                    const FT ymin = y0_ + iy * cell_size_ - pad;
+                    relation = classify_rect(t, xmin, xmin + cell_size_ + 2 * pad, ymin,
+                                             ymin + cell_size_ + 2 * pad);
+                }
+                if (relation == RectTriangleRelation::OUTSIDE) {
+                    deferred.push_back(cell);
+                    continue;
+                }
+                if (relation == RectTriangleRelation::INSIDE) result.occupied = true;
+                scan_cell(cell, true);
+            }
+        }
+        if (!result.occupied) return false;
+
+        // then the remaining cells within the query radius
+        for (const auto cell: deferred) {
+            scan_cell(cell, false);
+        }
+        const int cx0 = cell_x(c.x() - radius);
+        const int cx1 = cell_x(c.x() + radius);
+        const int cy0 = cell_y(c.y() - radius);
+        const int cy1 = cell_y(c.y() + radius);
+        for (int iy = cy0; iy <= cy1; ++iy) {
+            for (int ix = cx0; ix <= cx1; ++ix) {
+                if (ix >= tx0 && ix <= tx1 && iy >= ty0 && iy <= ty1) continue;
+                scan_cell(cell_index(ix, iy), false);
+            }
+        }
+
+        finish_rule_2_query(c, xs, ys, offset_size, result);
+        return true;
+    }
+
+    FT grid_oracle_2::squared_distance(const Point_2 &p) const {
+        if (!has_grid()) return point_set_oracle_2::squared_distance(p);
+        return CGAL::squared_distance(p, closest_point(p));
+    }
+
+    Point_2 grid_oracle_2::closest_point(const Point_2 &p) const {
+        if (!has_grid()) return point_set_oracle_2::closest_point(p);
+        return closest_point(p, std::numeric_limits<FT>::max(), Point_2());
+    }
+
+    void grid_oracle_2::squared_distances(const std::vector<Point_2> &points, std::vector<FT> &sq_distances) const {
+        if (!has_grid()) {
+            point_set_oracle_2::squared_distances(points, sq_distances);
+            return;
+        }
+
+        // the closest point of the previous query stops the ring search of the next one early
+        sq_distances.resize(points.size());
+        Point_2 nearest;
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            const auto &p = points[i];
+            nearest = i == 0
+                          ? closest_point(p, std::numeric_limits<FT>::max(), Point_2())
+                          : closest_point(p, CGAL::squared_distance(p, nearest), nearest);
+            sq_distances[i] = CGAL::squared_distance(p, nearest);
+        }
+    }
+
+    void grid_oracle_2::outside_offset(const std::vector<Point_2> &points, const FT offset_size,
+                                       std::vector<bool> &outside) const {
+        thread_local std::vector<FT> sq_distances;
+        squared_distances(points, sq_distances);
+        const FT sq_offset = offset_size * offset_size;
+        outside.resize(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            outside[i] = sq_distances[i] >= sq_offset;
+        }
+    }
+
+    Point_2 grid_oracle_2::closest_point(const Point_2 &p, FT best_sq_dist, Point_2 best) const {
+        const int cx = cell_x(p.x());
+        const int cy = cell_y(p.y());
+
+        auto visit_cell = [&](const int ix, const int iy) {
+            if (ix < 0 || iy < 0 || ix >= nx_ || iy >= ny_) return;
+            const auto c = cell_index(ix, iy);
+            for (auto i = cell_start_[c]; i < cell_start_[c + 1]; ++i) {
+                const FT d = CGAL::squared_distance(p, cell_point(i));
+                if (d < best_sq_dist) {
+                    best_sq_dist = d;
+                    best = cell_point(i);
+                }
+            }
+        };
+
+        // search rings of cells around the cell of p until no unvisited cell can contain a closer point
+        for (int r = 0; ; ++r) {
+            if (r == 0) {
+                visit_cell(cx, cy);
+            } else {
+                for (int ix = cx - r; ix <= cx + r; ++ix) {
+                    visit_cell(ix, cy - r);
+                    visit_cell(ix, cy + r);
+                }
+                for (int iy = cy - r + 1; iy <= cy + r - 1; ++iy) {
+                    visit_cell(cx - r, iy);
+                    visit_cell(cx + r, iy);
+                }
+            }
+
+            // lower bound on the distance to any cell outside the visited square
+            FT bound = std::numeric_limits<FT>::max();
+            bool done = true;
+            if (cx - r > 0) {
+                bound = std::min(bound, std::max<FT>(0.0, p.x() - (x0_ + (cx - r) * cell_size_)));
+                done = false;
+            }
+            if (cx + r < nx_ - 1) {
+                bound = std::min(bound, std::max<FT>(0.0, x0_ + (cx + r + 1) * cell_size_ - p.x()));
+                done = false;
+            }
+            if (cy - r > 0) {
+                bound = std::min(bound, std::max<FT>(0.0, p.y() - (y0_ + (cy - r) * cell_size_)));
+                done = false;
+            }
+            if (cy + r < ny_ - 1) {
+                bound = std::min(bound, std::max<FT>(0.0, y0_ + (cy + r + 1) * cell_size_ - p.y()));
+                done = false;
+            }
+            if (done || best_sq_dist <= bound * bound) break;
+        }
+        return best;
+    }
+
+    bool grid_oracle_2::first_intersection(const Point_2 &p, const Point_2 &q,
+                                           Point_2 &o,
+                                           const FT offset_size,
+                                           FT &lambda) const {
+        if (!has_grid()) return point_set_oracle_2::first_intersection(p, q, o, offset_size, lambda);
+
+        const FT dx = q.x() - p.x();
+        const FT dy = q.y() - p.y();
+        if (dx == 0 && dy == 0) return false; // degenerate segment
+
+        // only the part of the segment within offset_size of the grid can hit a circle
+        const FT grow = offset_size * (1.0 + 1e-9);
+        FT t_begin, t_end;
+        if (!clip_segment_to_box(p.x(), p.y(), dx, dy, x0_ - grow, x0_ + nx_ * cell_size_ + grow,
+                                 y0_ - grow, y0_ + ny_ * cell_size_ + grow, 1.0, t_begin, t_end)) {
+            return false;
+        }
+
+        // A circle hit at parameter t is centered at most k cells away from the cell containing the segment at t.
+        // The cells along the segment are walked in order (Amanatides-Woo), so the walk ends as soon as
+        // the best intersection lies before the exit of the current cell.
+        const int k = static_cast<int>(std::floor(grow * inv_cell_size_)) + 1;
+
+        const FT start_x = p.x() + t_begin * dx;
+        const FT start_y = p.y() + t_begin * dy;
+        int ix = static_cast<int>(std::floor((start_x - x0_) * inv_cell_size_));
+        int iy = static_cast<int>(std::floor((start_y - y0_) * inv_cell_size_));
+
+        const int step_x = dx > 0 ? 1 : -1;
+        const int step_y = dy > 0 ? 1 : -1;
+        const FT inf = std::numeric_limits<FT>::infinity();
+        FT t_next_x = dx != 0 ? (x0_ + (ix + (dx > 0 ? 1 : 0)) * cell_size_ - p.x()) / dx : inf;
+        FT t_next_y = dy != 0 ? (y0_ + (iy + (dy > 0 ? 1 : 0)) * cell_size_ - p.y()) / dy : inf;
+        const FT t_delta_x = dx != 0 ? cell_size_ / std::abs(dx) : inf;
+        const FT t_delta_y = dy != 0 ? cell_size_ / std::abs(dy) : inf;
+
+        bool found = false;
+        FT min_t = std::numeric_limits<FT>::max();
+
+        // neighborhood scanned in the previous step, its cells are skipped
+        int prev_x0 = 1, prev_x1 = 0, prev_y0 = 1, prev_y1 = 0;
+
+        while (true) {
+            const int nx0 = std::max(ix - k, 0);
+            const int nx1 = std::min(ix + k, nx_ - 1);
+            const int ny0 = std::max(iy - k, 0);
+            const int ny1 = std::min(iy + k, ny_ - 1);
+            for (int cy = ny0; cy <= ny1; ++cy) {
+                for (int cx = nx0; cx <= nx1; ++cx) {
+                    if (cx >= prev_x0 && cx <= prev_x1 && cy >= prev_y0 && cy <= prev_y1) continue;
+
+                    const auto c = cell_index(cx, cy);
+                    const auto begin = cell_start_[c];
+                    if (first_segment_circle_hit(p.x(), p.y(), q.x(), q.y(), cell_xs_.data() + begin,
+                                                 cell_ys_.data() + begin, cell_start_[c + 1] - begin,
+                                                 offset_size, min_t)) {
+                        found = true;
+                    }
+                }
+            }
+            prev_x0 = nx0;
+            prev_x1 = nx1;
+            prev_y0 = ny0;
+            prev_y1 = ny1;
+
+            const FT t_cell_exit = std::min({t_next_x, t_next_y, t_end});
+            if ((found && min_t <= t_cell_exit) || t_cell_exit >= t_end) break;
+
+            if (t_next_x < t_next_y) {
+                ix += step_x;
+                t_next_x += t_delta_x;
+            } else {
+                iy += step_y;
+                t_next_y += t_delta_y;
+            }
+        }
+
+        if (found) {
+            o = Point_2(p.x() + min_t * dx, p.y() + min_t * dy);
+            lambda = min_t;
+        }
+        return found;
+    }
+
+    bool grid_oracle_2::first_intersection(const Point_2 &p, const Point_2 &q,
+                                           Point_2 &o,
+                                           const FT offset_size) const {
+        FT dump;
+        return first_intersection(p, q, o, offset_size, dump);
+    }
+
+    Points grid_oracle_2::local_points(const Segment_2 &seg, const FT margin) const {
+        if (!has_grid()) return point_set_oracle_2::local_points(seg, margin);
+
+        Points local_pts;
+        const auto bbox = seg.bbox();
+        const FT x_min = bbox.xmin() - margin;
+        const FT x_max = bbox.xmax() + margin;
+        const FT y_min = bbox.ymin() - margin;
+        const FT y_max = bbox.ymax() + margin;
+
+        for (int iy = cell_y(y_min); iy <= cell_y(y_max); ++iy) {
+            for (int ix = cell_x(x_min); ix <= cell_x(x_max); ++ix) {
+                const auto c = cell_index(ix, iy);
+                for (auto i = cell_start_[c]; i < cell_start_[c + 1]; ++i) {
+                    const FT x = cell_xs_[i];
+                    const FT y = cell_ys_[i];
+                    if (x >= x_min && x <= x_max && y >= y_min && y <= y_max) {
+                        local_pts.emplace_back(x, y);
+                    }
+                }
+            }
+        }
+        return local_pts;
+    }
+
+    void grid_oracle_2::points_near_segment(const Segment_2 &seg, const FT distance, std::vector<FT> &xs,
+                                            std::vector<FT> &ys) const {
+        if (!has_grid()) {
+            point_set_oracle_2::points_near_segment(seg, distance, xs, ys);
+            return;
+        }
+
+        xs.clear();
+        ys.clear();
+        const SegmentStrip strip(seg, distance);
+        const FT pad = cell_size_ * 1e-9;
+        for (int iy = cell_y(strip.ymin); iy <= cell_y(strip.ymax); ++iy) {
+            for (int ix = cell_x(strip.xmin); ix <= cell_x(strip.xmax); ++ix) {
+                const auto c = cell_index(ix, iy);
+                if (cell_start_[c] == cell_start_[c + 1]) continue;
+
+                // same padding as in do_intersect, the clamped last row and column are always scanned
+                const FT xmin = x0_ + ix * cell_size_ - pad;
+                const FT ymin = y0_ + iy * cell_size_ - pad;
+                if (ix != nx_ - 1 && iy != ny_ - 1 &&
+                    !strip.may_overlap(xmin, xmin + cell_size_ + 2 * pad, ymin, ymin + cell_size_ + 2 * pad)) {
+                    continue;
+                }
+
+                for (auto i = cell_start_[c]; i < cell_start_[c + 1]; ++i) {
+                    if (strip.contains(cell_xs_[i], cell_ys_[i])) {
+                        xs.push_back(cell_xs_[i]);
+                        ys.push_back(cell_ys_[i]);
+                    }
+                }
+            }
+        }
+    }
+}
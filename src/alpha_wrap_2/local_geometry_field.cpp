@@ -0,0 +1,272 @@
+#include <alpha_wrap_2/local_geometry_field.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace aw2 {
+    namespace {
+        // Relative rounding allowance of the prefix sums. All moments are sums of non-negative terms, so a box
+        // sum obtained by inclusion-exclusion is accurate within this factor times the sum of the corner values
+        // for inputs of up to ~10^7 points.
+        constexpr FT prefix_rounding = 1e-8;
+    }
+
+    void LocalGeometryField::build(const std::vector<FT> &xs, const std::vector<FT> &ys, const FT offset,
+                                   const std::size_t memory_budget) {
+        const auto start = std::chrono::steady_clock::now();
+        prefix_.clear();
+        ring_.clear();
+        stats_ = LocalGeometryFieldStats();
+        if (xs.empty() || offset <= 0) return;
+
+        x0_ = *std::min_element(xs.begin(), xs.end());
+        x1_ = *std::max_element(xs.begin(), xs.end());
+        y0_ = *std::min_element(ys.begin(), ys.end());
+        y1_ = *std::max_element(ys.begin(), ys.end());
+
+        // coarsen until the prefix sums and the rings fit into the budget
+        FT cell_size = offset / 4;
+        for (;;) {
+            const FT cells_x = std::floor((x1_ - x0_) / cell_size) + 1;
+            const FT cells_y = std::floor((y1_ - y0_) / cell_size) + 1;
+            const FT bytes = (cells_x + 1) * (cells_y + 1) * sizeof(Moments) + cells_x * cells_y;
+            if (cells_x * cells_y <= FT(1 << 30) &&
+                (memory_budget == 0 || bytes <= static_cast<FT>(memory_budget))) {
+                nx_ = static_cast<int>(cells_x);
+                ny_ = static_cast<int>(cells_y);
+                break;
+            }
+            // a single cell does not get smaller, the criteria then run without a field
+            if (cells_x * cells_y <= 1) return;
+            cell_size *= 2;
+        }
+        cell_size_ = cell_size;
+        inv_cell_size_ = 1.0 / cell_size;
+
+        const auto n_cells = static_cast<std::size_t>(nx_) * ny_;
+        std::vector<Moments> cells(n_cells, Moments{0, 0, 0, 0, 0, 0});
+        for (std::size_t i = 0; i < xs.size(); ++i) {
+            const FT x = xs[i] - x0_;
+            const FT y = ys[i] - y0_;
+            auto &m = cells[static_cast<std::size_t>(cell_y(ys[i])) * nx_ + cell_x(xs[i])];
+            m.n += 1;
+            m.x += x;
+            m.y += y;
+            m.xx += x * x;
+            m.xy += x * y;
+            m.yy += y * y;
+        }
+
+        // chessboard distance transform, two passes are exact for this metric
+        ring_.assign(n_cells, max_ring);
+        for (std::size_t c = 0; c < n_cells; ++c) {
+            if (cells[c].n > 0) ring_[c] = 0;
+        }
+        const auto relax = [&](const int ix, const int iy, const int jx, const int jy) {
+            if (jx < 0 || jx >= nx_ || jy < 0 || jy >= ny_) return;
+            auto &d = ring_[static_cast<std::size_t>(iy) * nx_ + ix];
+            const int via = ring_[static_cast<std::size_t>(jy) * nx_ + jx] + 1;
+            if (via < d) d = static_cast<std::uint8_t>(via);
+        };
+        for (int iy = 0; iy < ny_; ++iy) {
+            for (int ix = 0; ix < nx_; ++ix) {
+                relax(ix, iy, ix - 1, iy);
+                relax(ix, iy, ix - 1, iy - 1);
+                relax(ix, iy, ix, iy - 1);
+                relax(ix, iy, ix + 1, iy - 1);
+            }
+        }
+        for (int iy = ny_ - 1; iy >= 0; --iy) {
+            for (int ix = nx_ - 1; ix >= 0; --ix) {
+                relax(ix, iy, ix + 1, iy);
+                relax(ix, iy, ix + 1, iy + 1);
+                relax(ix, iy, ix, iy + 1);
+                relax(ix, iy, ix - 1, iy + 1);
+            }
+        }
+
+        // prefix sums from running row sums, so every entry is a sum of non-negative terms
+        prefix_.assign(static_cast<std::size_t>(nx_ + 1) * (ny_ + 1), Moments{0, 0, 0, 0, 0, 0});
+        for (int iy = 0; iy < ny_; ++iy) {
+            Moments row{0, 0, 0, 0, 0, 0};
+            for (int ix = 0; ix < nx_; ++ix) {
+                const auto &m = cells[static_cast<std::size_t>(iy) * nx_ + ix];
+                row.n += m.n;
+                row.x += m.x;
+                row.y += m.y;
+                row.xx += m.xx;
+                row.xy += m.xy;
+                row.yy += m.yy;
+                const auto &below = prefix(ix + 1, iy);
+                prefix_[static_cast<std::size_t>(iy + 1) * (nx_ + 1) + ix + 1] = {
+                    below.n + row.n, below.x + row.x, below.y + row.y,
+                    below.xx + row.xx, below.xy + row.xy, below.yy + row.yy
+                };
+            }
+        }
+
+        stats_.resolution = cell_size_;
+        stats_.n_cells = n_cells;
+        stats_.memory_bytes = prefix_.size() * sizeof(Moments) + ring_.size();
+        stats_.build_time_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+    int LocalGeometryField::cell_x(const FT x) const {
+        const auto ix = static_cast<int>(std::floor((x - x0_) * inv_cell_size_));
+        return std::clamp(ix, 0, nx_ - 1);
+    }
+
+    int LocalGeometryField::cell_y(const FT y) const {
+        const auto iy = static_cast<int>(std::floor((y - y0_) * inv_cell_size_));
+        return std::clamp(iy, 0, ny_ - 1);
+    }
+
+    FT LocalGeometryField::distance_lower_bound(const FT x, const FT y) const {
+        if (empty()) return 0.0;
+
+        // all points lie in their bounding box
+        const FT dx = std::max({x0_ - x, FT(0), x - x1_});
+        const FT dy = std::max({y0_ - y, FT(0), y - y1_});
+        const FT to_box = std::sqrt(dx * dx + dy * dy) * (1.0 - 1e-9);
+
+        // points in a cell at chessboard distance k are separated from the query cell by k - 1 full cells,
+        // the cell assignment is monotone, so rounding can only cost a tiny fraction of a cell
+        const int k = ring_[static_cast<std::size_t>(cell_y(y)) * nx_ + cell_x(x)];
+        const FT to_ring = k > 1 ? (k - 1 - 1e-6) * cell_size_ : 0.0;
+        return std::max(to_box, to_ring);
+    }
+
+    LocalGeometryField::Moments LocalGeometryField::cell_range_moments(const int ix0, const int ix1,
+                                                                       const int iy0, const int iy1,
+                                                                       Moments &scale) const {
+        if (ix0 > ix1 || iy0 > iy1) {
+            scale = Moments{0, 0, 0, 0, 0, 0};
+            return scale;
+        }
+        const auto &p11 = prefix(ix1 + 1, iy1 + 1);
+        const auto &p01 = prefix(ix0, iy1 + 1);
+        const auto &p10 = prefix(ix1 + 1, iy0);
+        const auto &p00 = prefix(ix0, iy0);
+        scale = {
+            p11.n + p01.n + p10.n + p00.n, p11.x + p01.x + p10.x + p00.x, p11.y + p01.y + p10.y + p00.y,
+            p11.xx + p01.xx + p10.xx + p00.xx, p11.xy + p01.xy + p10.xy + p00.xy,
+            p11.yy + p01.yy + p10.yy + p00.yy
+        };
+        return {
+            p11.n - p01.n - p10.n + p00.n, p11.x - p01.x - p10.x + p00.x, p11.y - p01.y - p10.y + p00.y,
+            p11.xx - p01.xx - p10.xx + p00.xx, p11.xy - p01.xy - p10.xy + p00.xy,
+            p11.yy - p01.yy - p10.yy + p00.yy
+        };
+    }
+
+    std::size_t LocalGeometryField::cell_range_count(const int ix0, const int ix1, const int iy0,
+                                                     const int iy1) const {
+        if (ix0 > ix1 || iy0 > iy1) return 0;
+        // counts are exact integers
+        return static_cast<std::size_t>(prefix(ix1 + 1, iy1 + 1).n - prefix(ix0, iy1 + 1).n -
+                                        prefix(ix1 + 1, iy0).n + prefix(ix0, iy0).n);
+    }
+
+    std::size_t LocalGeometryField::box_count_upper(const FT xmin, const FT xmax, const FT ymin,
+                                                    const FT ymax) const {
+        if (xmax < x0_ || xmin > x1_ || ymax < y0_ || ymin > y1_) return 0;
+        return cell_range_count(cell_x(xmin), cell_x(xmax), cell_y(ymin), cell_y(ymax));
+    }
+
+    BoxDeviationBounds LocalGeometryField::box_deviation_bounds(const FT ax, const FT ay, const FT bx, const FT by,
+                                                                const FT xmin, const FT xmax,
+                                                                const FT ymin, const FT ymax) const {
+        BoxDeviationBounds bounds;
+        if (empty()) {
+            bounds.n_upper = std::numeric_limits<std::size_t>::max();
+            bounds.sum_upper = std::numeric_limits<FT>::infinity();
+            return bounds;
+        }
+        if (xmax < x0_ || xmin > x1_ || ymax < y0_ || ymin > y1_) return bounds;
+
+        // The cell assignment is monotone in the coordinates, so the cells overlapping the box hold every point
+        // of the box and the cells strictly between the boundary cells only hold points of the box.
+        const int ix0 = cell_x(xmin), ix1 = cell_x(xmax);
+        const int iy0 = cell_y(ymin), iy1 = cell_y(ymax);
+        Moments outer_scale, inner_scale;
+        const auto outer = cell_range_moments(ix0, ix1, iy0, iy1, outer_scale);
+        const auto inner = cell_range_moments(ix0 + 1, ix1 - 1, iy0 + 1, iy1 - 1, inner_scale);
+        bounds.n_upper = static_cast<std::size_t>(outer.n);
+        bounds.n_lower = static_cast<std::size_t>(inner.n);
+
+        // The squared distance to the segment is the squared distance to its line plus the squared overshoot of
+        // the projection beyond the endpoints. The line part is a quadratic form in the moments.
+        const FT ux = bx - ax, uy = by - ay;
+        const FT length = std::sqrt(ux * ux + uy * uy);
+        const FT rax = ax - x0_, ray = ay - y0_;
+        FT nx = 0.0, ny = 0.0, c = 0.0;
+        if (length > 0) {
+            nx = -uy / length;
+            ny = ux / length;
+            c = nx * rax + ny * ray;
+        }
+        const auto line_sum = [&](const Moments &m, const Moments &scale, FT &error) {
+            if (length == 0) {
+                // distance to the point a
+                error = 2 * prefix_rounding * (scale.xx + scale.yy + 2 * (std::abs(rax) * scale.x +
+                                                   std::abs(ray) * scale.y) + (rax * rax + ray * ray) * scale.n);
+                return m.xx + m.yy - 2 * (rax * m.x + ray * m.y) + (rax * rax + ray * ray) * m.n;
+            }
+            error = 2 * prefix_rounding * (nx * nx * scale.xx + 2 * std::abs(nx * ny) * scale.xy +
+                                           ny * ny * scale.yy +
+                                           2 * std::abs(c) * (std::abs(nx) * scale.x + std::abs(ny) * scale.y) +
+                                           c * c * scale.n);
+            return nx * nx * m.xx + 2 * nx * ny * m.xy + ny * ny * m.yy - 2 * c * (nx * m.x + ny * m.y) +
+                   c * c * m.n;
+        };
+
+        FT inner_error, outer_error;
+        const FT inner_sum = line_sum(inner, inner_scale, inner_error);
+        const FT outer_sum = line_sum(outer, outer_scale, outer_error);
+        bounds.sum_lower = std::max(FT(0), inner_sum - inner_error);
+        bounds.sum_upper = std::max(FT(0), outer_sum) + outer_error;
+        if (length == 0 || bounds.n_upper == 0) return bounds;
+
+        // Overshoot beyond each endpoint: at most the deepest box corner, for at most the points in the bounding
+        // box of the part of the box beyond the endpoint.
+        const FT corners[4][2] = {{xmin, ymin}, {xmax, ymin}, {xmax, ymax}, {xmin, ymax}};
+        const FT slack = 1e-9 * (xmax - xmin + ymax - ymin + length);
+        for (int end = 0; end < 2; ++end) {
+            FT depth[4];
+            FT max_depth = 0.0;
+            for (int k = 0; k < 4; ++k) {
+                const FT t = ((corners[k][0] - ax) * ux + (corners[k][1] - ay) * uy) / length;
+                depth[k] = end == 0 ? -t : t - length;
+                max_depth = std::max(max_depth, depth[k]);
+            }
+            if (max_depth <= 0) continue;
+
+            // clip the box to the part beyond the endpoint
+            FT cap_xmin = std::numeric_limits<FT>::infinity(), cap_xmax = -cap_xmin;
+            FT cap_ymin = cap_xmin, cap_ymax = -cap_xmin;
+            const auto extend = [&](const FT x, const FT y) {
+                cap_xmin = std::min(cap_xmin, x);
+                cap_xmax = std::max(cap_xmax, x);
+                cap_ymin = std::min(cap_ymin, y);
+                cap_ymax = std::max(cap_ymax, y);
+            };
+            for (int k = 0; k < 4; ++k) {
+                const int l = (k + 1) % 4;
+                if (depth[k] >= 0) extend(corners[k][0], corners[k][1]);
+                if ((depth[k] >= 0) != (depth[l] >= 0)) {
+                    const FT s = depth[k] / (depth[k] - depth[l]);
+                    extend(corners[k][0] + s * (corners[l][0] - corners[k][0]),
+                           corners[k][1] + s * (corners[l][1] - corners[k][1]));
+                }
+            }
+            const auto n_cap = box_count_upper(cap_xmin - slack, cap_xmax + slack, cap_ymin - slack,
+                                               cap_ymax + slack);
+            const FT overshoot = max_depth + slack;
+            bounds.sum_upper += static_cast<FT>(n_cap) * overshoot * overshoot;
+        }
+        return bounds;
+    }
+}
@@ -0,0 +1,140 @@
+#include "alpha_wrap_2/point_order.h"
+#include "alpha_wrap_2/thread_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace aw2 {
+    namespace {
+        // below this size the reordering runs on the calling thread
+        constexpr std::size_t min_parallel_points = std::size_t(1) << 16;
+
+        // spreads the 32 bits of v to the even bits of the result
+        std::uint64_t spread_bits(std::uint64_t v) {
+            v = (v | (v << 16)) & 0x0000ffff0000ffffULL;
+            v = (v | (v << 8)) & 0x00ff00ff00ff00ffULL;
+            v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+            v = (v | (v << 2)) & 0x3333333333333333ULL;
+            v = (v | (v << 1)) & 0x5555555555555555ULL;
+            return v;
+        }
+
+        std::uint64_t morton_key(const std::uint32_t x, const std::uint32_t y) {
+            return spread_bits(x) | (spread_bits(y) << 1);
+        }
+
+        // distance along the Hilbert curve of order 32
+        std::uint64_t hilbert_key(std::uint32_t x, std::uint32_t y) {
+            std::uint64_t d = 0;
+            for (std::uint32_t s = std::uint32_t(1) << 31; s > 0; s >>= 1) {
+                const std::uint32_t rx = (x & s) > 0;
+                const std::uint32_t ry = (y & s) > 0;
+                d += static_cast<std::uint64_t>(s) * s * ((3 * rx) ^ ry);
+                // rotate the quadrant
+                if (ry == 0) {
+                    if (rx == 1) {
+                        x = ~x;
+                        y = ~y;
+                    }
+                    std::swap(x, y);
+                }
+            }
+            return d;
+        }
+    }
+
+    std::string point_order_name(const PointOrder order) {
+        switch (order) {
+            case FILE_ORDER:
+                return "FILE";
+            case MORTON_ORDER:
+                return "MORTON";
+            case HILBERT_ORDER:
+                return "HILBERT";
+        }
+        throw std::invalid_argument("Unknown point order.");
+    }
+
+    PointOrder point_order_from_name(const std::string &name) {
+        for (const auto order: {FILE_ORDER, MORTON_ORDER, HILBERT_ORDER}) {
+            if (point_order_name(order) == name) return order;
+        }
+        throw std::invalid_argument("Unknown point order: " + name);
+    }
+
+    void reorder_points(Points &points, const PointOrder order, const unsigned n_threads) {
+        if (order == FILE_ORDER || points.size() < 2) return;
+
+        FT x_min = points.front().x(), x_max = x_min;
+        FT y_min = points.front().y(), y_max = y_min;
+        for (const auto &p: points) {
+            x_min = std::min(x_min, p.x());
+            x_max = std::max(x_max, p.x());
+            y_min = std::min(y_min, p.y());
+            y_max = std::max(y_max, p.y());
+        }
+
+        // quantize both axes with the same scale onto 32 bit integers
+        const FT extent = std::max(x_max - x_min, y_max - y_min);
+        const FT scale = extent > 0 ? 4294967295.0 / extent : 0.0;
+        const auto quantize = [scale](const FT v) {
+            return static_cast<std::uint32_t>(std::clamp(v * scale, 0.0, 4294967295.0));
+        };
+
+        std::unique_ptr<ThreadPool> pool;
+        if (n_threads != 1 && points.size() >= min_parallel_points) {
+            pool = std::make_unique<ThreadPool>(n_threads);
+        }
+        const std::size_t n_chunks = pool ? 4 * pool->size() : 1;
+        const std::size_t chunk_size = (points.size() + n_chunks - 1) / n_chunks;
+        const auto for_each_chunk = [&](const std::function<void(std::size_t, std::size_t)> &fn) {
+            const std::function<void(std::size_t)> chunk_fn = [&](const std::size_t c) {
+                const std::size_t begin = std::min(points.size(), c * chunk_size);
+                fn(begin, std::min(points.size(), begin + chunk_size));
+            };
+            if (pool) {
+                pool->parallel_for(n_chunks, chunk_fn);
+            } else {
+                chunk_fn(0);
+            }
+        };
+
+        // (key, index) pairs, the index keeps the sort stable
+        std::vector<std::pair<std::uint64_t, std::uint32_t> > keys(points.size());
+        for_each_chunk([&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const auto x = quantize(points[i].x() - x_min);
+                const auto y = quantize(points[i].y() - y_min);
+                keys[i] = {order == MORTON_ORDER ? morton_key(x, y) : hilbert_key(x, y),
+                           static_cast<std::uint32_t>(i)};
+            }
+            std::sort(keys.begin() + begin, keys.begin() + end);
+        });
+
+        // merge the sorted chunks pairwise
+        if (pool) {
+            for (std::size_t width = chunk_size; width < points.size(); width *= 2) {
+                const std::size_t n_merges = (points.size() + 2 * width - 1) / (2 * width);
+                pool->parallel_for(n_merges, [&](const std::size_t m) {
+                    const std::size_t begin = m * 2 * width;
+                    const std::size_t middle = std::min(points.size(), begin + width);
+                    const std::size_t end = std::min(points.size(), begin + 2 * width);
+                    std::inplace_merge(keys.begin() + begin, keys.begin() + middle, keys.begin() + end);
+                });
+            }
+        }
+
+        Points sorted(points.size());
+        for_each_chunk([&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                sorted[i] = points[keys[i].second];
+            }
+        });
+        points.swap(sorted);
+    }
+}
@@ -1,34 +1,183 @@
 #include <alpha_wrap_2/point_set_oracle_2.h>
+#include "query_utils.h"
+#include "segment_circle_kernel.h"
 
 namespace aw2 {
-    // Forward declaration of segment_circle_intersection
-    bool segment_circle_intersection(const Point_2 &p, const Point_2 &q, const Point_2 &center, FT radius, Point_2 &o,
-                                     FT &lambda);
-
     bool point_set_oracle_2::empty() const { return tree_.empty(); }
     bool point_set_oracle_2::do_call() const { return (!empty()); }
     void point_set_oracle_2::clear() { tree_.clear(); }
 
     bool point_set_oracle_2::do_intersect(const K::Triangle_2 &t) const {
-        if (tree_.empty()) return false;
+        std::size_t n_visited;
+        return do_intersect(t, n_visited);
+    }
+
+    bool point_set_oracle_2::do_intersect(const K::Triangle_2 &triangle, std::size_t &n_visited) const {
+        n_visited = 0;
+        if (tree_.empty() || triangle.is_degenerate()) return false;
+
+        const K::Triangle_2 t = triangle.orientation() == CGAL::COUNTERCLOCKWISE ? triangle : triangle.opposite();
         const auto bbox = t.bbox();
-        const auto min = Point_2(bbox.xmin(), bbox.ymin());
-        const auto max = Point_2(bbox.xmax(), bbox.ymax());
 
-        // Fuzzy box query to restrict candidates
-        const CGAL::Fuzzy_iso_box<CGAL::Search_traits_2<K> > box(min, max);
+        struct Entry {
+            Tree::Node_const_handle node;
+            FT xmin, xmax, ymin, ymax;
+        };
+        thread_local std::vector<Entry> stack;
+        stack.clear();
+
+        const auto &root_box = tree_.bounding_box();
+        stack.push_back({tree_.root(), root_box.min_coord(0), root_box.max_coord(0), root_box.min_coord(1),
+                         root_box.max_coord(1)});
+
+        while (!stack.empty()) {
+            const Entry e = stack.back();
+            stack.pop_back();
+
+            if (e.xmax < bbox.xmin() || e.xmin > bbox.xmax() || e.ymax < bbox.ymin() || e.ymin > bbox.ymax()) {
+                continue;
+            }
+
+            const auto relation = classify_rect(t, e.xmin, e.xmax, e.ymin, e.ymax);
+            if (relation == RectTriangleRelation::OUTSIDE) continue;
+
+            if (relation == RectTriangleRelation::INSIDE) {
+                // every point of the subtree is inside, it only has to contain one
+                thread_local std::vector<Tree::Node_const_handle> nodes;
+                nodes.assign(1, e.node);
+                while (!nodes.empty()) {
+                    const auto node = nodes.back();
+                    nodes.pop_back();
+                    if (node->is_leaf()) {
+                        if (static_cast<Tree::Leaf_node_const_handle>(node)->size() > 0) {
+                            ++n_visited;
+                            return true;
+                        }
+                    } else {
+                        const auto internal = static_cast<Tree::Internal_node_const_handle>(node);
+                        nodes.push_back(internal->lower());
+                        nodes.push_back(internal->upper());
+                    }
+                }
+                continue;
+            }
 
-        std::vector<Point_2> candidates;
-        tree_.search(std::back_inserter(candidates), box);
+            if (e.node->is_leaf()) {
+                const auto leaf = static_cast<Tree::Leaf_node_const_handle>(e.node);
+                for (auto it = leaf->begin(); it != leaf->end(); ++it) {
+                    ++n_visited;
+                    if (t.has_on_bounded_side(*it)) {
+                        return true;
+                    }
+                }
+                continue;
+            }
 
-        for (const auto &pt: candidates) {
-            if (t.has_on_bounded_side(pt)) {
-                return true;
+            // split the node rectangle at the cutting value
+            const auto node = static_cast<Tree::Internal_node_const_handle>(e.node);
+            Entry lower{node->lower(), e.xmin, e.xmax, e.ymin, e.ymax};
+            Entry upper{node->upper(), e.xmin, e.xmax, e.ymin, e.ymax};
+            if (node->cutting_dimension() == 0) {
+                lower.xmax = upper.xmin = node->cutting_value();
+            } else {
+                lower.ymax = upper.ymin = node->cutting_value();
             }
+            stack.push_back(upper);
+            stack.push_back(lower);
         }
         return false;
     }
 
+    bool point_set_oracle_2::rule_2_query(const K::Triangle_2 &triangle, const Point_2 &c, const FT offset_size,
+                                          Rule2Query &result) const {
+        result = Rule2Query();
+        if (tree_.empty() || triangle.is_degenerate()) return false;
+
+        const K::Triangle_2 t = triangle.orientation() == CGAL::COUNTERCLOCKWISE ? triangle : triangle.opposite();
+        const auto bbox = t.bbox();
+
+        // The closest point to c of an occupied face lies inside the circumcircle, so the projection and every
+        // offset circle hit by the segment towards it are found among the points within the circumradius plus
+        // the offset. Nodes overlapping the face are visited first and the others are only visited once the
+        // face is known to be occupied.
+        const FT radius = rule_2_query_radius(t, c, offset_size);
+        const FT sq_radius = radius * radius;
+
+        struct Entry {
+            Tree::Node_const_handle node;
+            FT xmin, xmax, ymin, ymax;
+            // the node rectangle lies strictly inside the face
+            bool inside;
+        };
+        thread_local std::vector<Entry> stack, deferred;
+        thread_local std::vector<FT> xs, ys;
+        stack.clear();
+        deferred.clear();
+        xs.clear();
+        ys.clear();
+
+        const auto &root_box = tree_.bounding_box();
+        stack.push_back({tree_.root(), root_box.min_coord(0), root_box.max_coord(0), root_box.min_coord(1),
+                         root_box.max_coord(1), false});
+
+        for (;;) {
+            while (!stack.empty()) {
+                Entry e = stack.back();
+                stack.pop_back();
+
+                if (squared_distance_to_box(c.x(), c.y(), e.xmin, e.xmax, e.ymin, e.ymax) > sq_radius) continue;
+
+                if (!result.occupied && !e.inside) {
+                    const auto relation =
+                        e.xmax < bbox.xmin() || e.xmin > bbox.xmax() || e.ymax < bbox.ymin() || e.ymin > bbox.ymax()
+                            ? RectTriangleRelation::OUTSIDE
+                            : classify_rect(t, e.xmin, e.xmax, e.ymin, e.ymax);
+                    if (relation == RectTriangleRelation::OUTSIDE) {
+                        deferred.push_back(e);
+                        continue;
+                    }
+                    e.inside = relation == RectTriangleRelation::INSIDE;
+                }
+
+                if (e.node->is_leaf()) {
+                    const auto leaf = static_cast<Tree::Leaf_node_const_handle>(e.node);
+                    if (e.inside && leaf->size() > 0) result.occupied = true;
+                    for (auto it = leaf->begin(); it != leaf->end(); ++it) {
+                        ++result.n_visited;
+                        if (!result.occupied && t.has_on_bounded_side(*it)) {
+                            result.occupied = true;
+                        }
+                        if (CGAL::squared_distance(c, *it) <= sq_radius) {
+                            xs.push_back(it->x());
+                            ys.push_back(it->y());
+                        }
+                    }
+                } else {
+                    // split the node rectangle at the cutting value
+                    const auto node = static_cast<Tree::Internal_node_const_handle>(e.node);
+                    Entry lower{node->lower(), e.xmin, e.xmax, e.ymin, e.ymax, e.inside};
+                    Entry upper{node->upper(), e.xmin, e.xmax, e.ymin, e.ymax, e.inside};
+                    if (node->cutting_dimension() == 0) {
+                        lower.xmax = upper.xmin = node->cutting_value();
+                    } else {
+                        lower.ymax = upper.ymin = node->cutting_value();
+                    }
+                    stack.push_back(upper);
+                    stack.push_back(lower);
+                }
+            }
+
+            // the face is occupied, now visit the remaining nodes for the projection
+            if (!result.occupied || deferred.empty()) break;
+            stack.swap(deferred);
+        }
+
+        if (!result.occupied) return false;
+
+        finish_rule_2_query(c, xs, ys, offset_size, result);
+        return true;
+    }
+
     FT point_set_oracle_2::squared_distance(const Point_2 &p) const {
         if (tree_.empty()) return 0.0;
 
@@ -36,6 +185,17 @@ namespace aw2 {
         return search.begin()->second; // squared distance to nearest neighbor
     }
 
+    void point_set_oracle_2::outside_offset(const std::vector<Point_2> &points, const FT offset_size,
+                                            std::vector<bool> &outside) const {
+        thread_local std::vector<FT> sq_distances;
+        squared_distances(points, sq_distances);
+        const FT sq_offset = offset_size * offset_size;
+        outside.resize(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            outside[i] = sq_distances[i] >= sq_offset;
+        }
+    }
+
     Point_2 point_set_oracle_2::closest_point(const Point_2 &p) const {
         if (tree_.empty()) return Point_2(0, 0);
 
@@ -43,62 +203,162 @@ namespace aw2 {
         return search.begin()->first; // nearest point
     }
 
+    void point_set_oracle_2::squared_distances(const std::vector<Point_2> &points,
+                                               std::vector<FT> &sq_distances) const {
+        sq_distances.assign(points.size(), 0.0);
+        if (tree_.empty()) return;
+
+        struct Entry {
+            Tree::Node_const_handle node;
+            FT xmin, xmax, ymin, ymax;
+        };
+        thread_local std::vector<Entry> stack;
+
+        const auto &root_box = tree_.bounding_box();
+        bool has_nearest = false;
+        Point_2 nearest;
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            const auto &p = points[i];
+            FT best = has_nearest ? CGAL::squared_distance(p, nearest) : std::numeric_limits<FT>::max();
+
+            stack.clear();
+            stack.push_back({tree_.root(), root_box.min_coord(0), root_box.max_coord(0), root_box.min_coord(1),
+                             root_box.max_coord(1)});
+            while (!stack.empty()) {
+                const Entry e = stack.back();
+                stack.pop_back();
+
+                if (squared_distance_to_box(p.x(), p.y(), e.xmin, e.xmax, e.ymin, e.ymax) >= best) continue;
+
+                if (e.node->is_leaf()) {
+                    const auto leaf = static_cast<Tree::Leaf_node_const_handle>(e.node);
+                    for (auto it = leaf->begin(); it != leaf->end(); ++it) {
+                        if (const FT d = CGAL::squared_distance(p, *it); d < best) {
+                            best = d;
+                            nearest = *it;
+                            has_nearest = true;
+                        }
+                    }
+                    continue;
+                }
+
+                // split the node rectangle at the cutting value, the side of p is visited first
+                const auto node = static_cast<Tree::Internal_node_const_handle>(e.node);
+                Entry lower{node->lower(), e.xmin, e.xmax, e.ymin, e.ymax};
+                Entry upper{node->upper(), e.xmin, e.xmax, e.ymin, e.ymax};
+                bool p_lower;
+                if (node->cutting_dimension() == 0) {
+                    lower.xmax = upper.xmin = node->cutting_value();
+                    p_lower = p.x() < node->cutting_value();
+                } else {
+                    lower.ymax = upper.ymin = node->cutting_value();
+                    p_lower = p.y() < node->cutting_value();
+                }
+                if (p_lower) {
+                    stack.push_back(upper);
+                    stack.push_back(lower);
+                } else {
+                    stack.push_back(lower);
+                    stack.push_back(upper);
+                }
+            }
+            sq_distances[i] = best;
+        }
+    }
+
     bool point_set_oracle_2::first_intersection(const Point_2 &p, const Point_2 &q,
                                                 Point_2 &o,
                                                 const FT offset_size,
                                                 FT &lambda) const {
         if (tree_.empty()) return false;
-        const Segment_2 seg(p, q);
-
-        // get a bounding box with margins so we narrow down the search
-        const CGAL::Bbox_2 bbox = seg.bbox();
-        const Point_2 min(bbox.xmin() - offset_size, bbox.ymin() - offset_size);
-        const Point_2 max(bbox.xmax() + offset_size, bbox.ymax() + offset_size);
-        const CGAL::Fuzzy_iso_box<Traits> box(min, max);
 
-        std::vector<Point_2> candidates;
-        tree_.search(std::back_inserter(candidates), box);
-
-        if (candidates.empty()) {
+        const FT dx = q.x() - p.x();
+        const FT dy = q.y() - p.y();
+        if (dx == 0 && dy == 0) return false; // degenerate segment
+
+        // A circle of radius offset_size around a point inside a node can only be hit by the segment inside
+        // the node rectangle grown by offset_size. Nodes are visited near-to-far along the segment and pruned
+        // as soon as they are entered after the best intersection found so far.
+        // The rectangle is grown slightly more to stay conservative under rounding.
+        const FT grow = offset_size * (1.0 + 1e-9);
+
+        struct Entry {
+            Tree::Node_const_handle node;
+            FT xmin, xmax, ymin, ymax;
+            FT t_enter;
+        };
+        thread_local std::vector<Entry> stack;
+        stack.clear();
+
+        // leaf points in structure-of-arrays layout for the batched intersection kernel
+        thread_local std::vector<FT> leaf_xs, leaf_ys;
+
+        const auto &root_box = tree_.bounding_box();
+        Entry root{tree_.root(), root_box.min_coord(0), root_box.max_coord(0), root_box.min_coord(1),
+                   root_box.max_coord(1), 0.0};
+        if (!clip_segment_to_box(p.x(), p.y(), dx, dy, root.xmin - grow, root.xmax + grow,
+                                 root.ymin - grow, root.ymax + grow, 1.0, root.t_enter)) {
             return false;
         }
-
-        // Create a temporary kd-tree from candidates for efficient proximity search
-        const Tree candidates_tree(candidates.begin(), candidates.end());
-        const Incremental_neighbor_search inc_search(candidates_tree, p);
-
-        // Precompute segment length for distance pruning
-        FT seg_length = std::sqrt(CGAL::squared_distance(p, q));
+        stack.push_back(root);
 
         bool found = false;
         FT min_t = std::numeric_limits<FT>::max();
-        FT max_sq_dist = std::numeric_limits<FT>::max();
-        Point_2 best_intersection;
 
-        // Iterate through candidates by proximity to p
-        for (auto it = inc_search.begin(); it != inc_search.end(); ++it) {
-            if (found && it->second > max_sq_dist) {
-                break; // No need to check further candidates (it->second is squared distance)
+        while (!stack.empty()) {
+            const Entry e = stack.back();
+            stack.pop_back();
+            if (e.t_enter >= min_t) continue;
+
+            if (e.node->is_leaf()) {
+                const auto leaf = static_cast<Tree::Leaf_node_const_handle>(e.node);
+                leaf_xs.clear();
+                leaf_ys.clear();
+                for (auto it = leaf->begin(); it != leaf->end(); ++it) {
+                    leaf_xs.push_back(it->x());
+                    leaf_ys.push_back(it->y());
+                }
+                if (first_segment_circle_hit(p.x(), p.y(), q.x(), q.y(), leaf_xs.data(), leaf_ys.data(),
+                                             leaf_xs.size(), offset_size, min_t)) {
+                    found = true;
+                }
+                continue;
             }
 
-            Point_2 intersection;
-            FT t;
-
-            if (!segment_circle_intersection(p, q, it->first, offset_size, intersection, t)) continue;
-            if (t >= min_t) continue;
-
-            min_t = t;
-            best_intersection = intersection;
+            // split the node rectangle at the cutting value
+            const auto node = static_cast<Tree::Internal_node_const_handle>(e.node);
+            Entry lower{node->lower(), e.xmin, e.xmax, e.ymin, e.ymax, 0.0};
+            Entry upper{node->upper(), e.xmin, e.xmax, e.ymin, e.ymax, 0.0};
+            if (node->cutting_dimension() == 0) {
+                lower.xmax = upper.xmin = node->cutting_value();
+            } else {
+                lower.ymax = upper.ymin = node->cutting_value();
+            }
 
-            if (!found) {
-                found = true;
-                max_sq_dist = std::pow(min_t * seg_length + offset_size, 2);
-                // only update when we find the first intersection
+            const FT t_max = std::min<FT>(1.0, min_t);
+            const bool visit_lower = clip_segment_to_box(p.x(), p.y(), dx, dy, lower.xmin - grow, lower.xmax + grow,
+                                                         lower.ymin - grow, lower.ymax + grow, t_max, lower.t_enter);
+            const bool visit_upper = clip_segment_to_box(p.x(), p.y(), dx, dy, upper.xmin - grow, upper.xmax + grow,
+                                                         upper.ymin - grow, upper.ymax + grow, t_max, upper.t_enter);
+
+            // push the farther child first so the nearer one is processed next
+            if (visit_lower && visit_upper) {
+                if (lower.t_enter <= upper.t_enter) {
+                    stack.push_back(upper);
+                    stack.push_back(lower);
+                } else {
+                    stack.push_back(lower);
+                    stack.push_back(upper);
+                }
+            } else if (visit_lower) {
+                stack.push_back(lower);
+            } else if (visit_upper) {
+                stack.push_back(upper);
             }
         }
 
         if (found) {
-            o = best_intersection;
+            o = Point_2(p.x() + min_t * dx, p.y() + min_t * dy);
             lambda = min_t;
         }
         return found;
@@ -111,17 +371,36 @@ namespace aw2 {
         return first_intersection(p, q, o, offset_size, dump);
     }
 
-    void point_set_oracle_2::add_point_set(const Points &points) {
-        tree_.insert(points.cbegin(), points.cend());
+    FT point_set_oracle_2::bbox_diagonal_length() const {
+        return std::sqrt(CGAL::squared_distance(
+            Point_2(bbox_.x_min, bbox_.y_min),
+            Point_2(bbox_.x_max, bbox_.y_max)
+        ));
     }
 
-    void point_set_oracle_2::load_points(const std::string &filename) {
-        auto points = std::vector<Point_2>();
-        std::ifstream input(filename);
-        double x, y;
-        while (input >> x >> y) {
-            points.emplace_back(x, y);
+    std::size_t point_set_oracle_2::size() const { return tree_.size(); }
+
+    void point_set_oracle_2::prepare(const OracleParams &) {
+        // build the tree up front instead of lazily on the first query
+        if (!tree_.empty()) {
+            tree_.build();
+        }
+    }
 
+    void point_set_oracle_2::build_local_geometry_field(const OracleParams &params) {
+        std::vector<FT> xs, ys;
+        xs.reserve(tree_.size());
+        ys.reserve(tree_.size());
+        for (const auto &p: tree_) {
+            xs.push_back(p.x());
+            ys.push_back(p.y());
+        }
+        local_field_.build(xs, ys, params.offset, params.memory_budget);
+    }
+
+    void point_set_oracle_2::add_point_set(const Points &points) {
+        for (const auto &p: points) {
+            const FT x = p.x(), y = p.y();
             if (x < bbox_.x_min)
                 bbox_.x_min = x;
             if (x > bbox_.x_max)
@@ -132,7 +411,70 @@ namespace aw2 {
                 bbox_.y_max = y;
         }
 
-        add_point_set(points);
+        tree_.insert(points.cbegin(), points.cend());
+    }
+
+    void point_set_oracle_2::load_points(const std::string &filename) {
+        add_point_set(read_points(filename));
+    }
+
+    Points point_set_oracle_2::read_points(const std::string &filename) {
+        auto points = std::vector<Point_2>();
+        std::ifstream input(filename);
+        double x, y;
+        while (input >> x >> y) {
+            points.emplace_back(x, y);
+        }
+        return points;
+    }
+
+    void point_set_oracle_2::points_near_segment(const Segment_2 &seg, const FT distance, std::vector<FT> &xs,
+                                                 std::vector<FT> &ys) const {
+        xs.clear();
+        ys.clear();
+        if (tree_.empty()) return;
+
+        const SegmentStrip strip(seg, distance);
+
+        struct Entry {
+            Tree::Node_const_handle node;
+            FT xmin, xmax, ymin, ymax;
+        };
+        thread_local std::vector<Entry> stack;
+        stack.clear();
+
+        const auto &root_box = tree_.bounding_box();
+        stack.push_back({tree_.root(), root_box.min_coord(0), root_box.max_coord(0), root_box.min_coord(1),
+                         root_box.max_coord(1)});
+
+        while (!stack.empty()) {
+            const Entry e = stack.back();
+            stack.pop_back();
+
+            if (!strip.may_overlap(e.xmin, e.xmax, e.ymin, e.ymax)) continue;
+
+            if (e.node->is_leaf()) {
+                const auto leaf = static_cast<Tree::Leaf_node_const_handle>(e.node);
+                for (auto it = leaf->begin(); it != leaf->end(); ++it) {
+                    if (strip.contains(it->x(), it->y())) {
+                        xs.push_back(it->x());
+                        ys.push_back(it->y());
+                    }
+                }
+                continue;
+            }
+
+            const auto node = static_cast<Tree::Internal_node_const_handle>(e.node);
+            Entry lower{node->lower(), e.xmin, e.xmax, e.ymin, e.ymax};
+            Entry upper{node->upper(), e.xmin, e.xmax, e.ymin, e.ymax};
+            if (node->cutting_dimension() == 0) {
+                lower.xmax = upper.xmin = node->cutting_value();
+            } else {
+                lower.ymax = upper.ymin = node->cutting_value();
+            }
+            stack.push_back(upper);
+            stack.push_back(lower);
+        }
     }
 
     Points point_set_oracle_2::local_points(const Segment_2 &seg, const FT margin) const {
@@ -149,6 +491,29 @@ namespace aw2 {
         return local_pts;
     }
 
+    void finish_rule_2_query(const Point_2 &c, const std::vector<FT> &xs, const std::vector<FT> &ys,
+                             const FT offset_size, Rule2Query &result) {
+        FT best_sq_dist = std::numeric_limits<FT>::max();
+        std::size_t best = 0;
+        for (std::size_t i = 0; i < xs.size(); ++i) {
+            const FT dx = xs[i] - c.x();
+            const FT dy = ys[i] - c.y();
+            const FT d = dx * dx + dy * dy;
+            if (d < best_sq_dist) {
+                best_sq_dist = d;
+                best = i;
+            }
+        }
+        result.projection = Point_2(xs[best], ys[best]);
+
+        FT t = std::numeric_limits<FT>::max();
+        result.intersects = first_segment_circle_hit(c.x(), c.y(), xs[best], ys[best], xs.data(), ys.data(),
+                                                     xs.size(), offset_size, t);
+        if (result.intersects) {
+            result.steiner_point = Point_2(c.x() + t * (xs[best] - c.x()), c.y() + t * (ys[best] - c.y()));
+        }
+    }
+
     bool segment_circle_intersection(const Point_2 &p, const Point_2 &q, const Point_2 &center, FT radius, Point_2 &o,
                                      FT &lambda) {
         const auto dx = q.x() - p.x();
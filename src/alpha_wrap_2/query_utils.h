@@ -0,0 +1,150 @@
+// Internal helpers shared by the oracle implementations
+#ifndef AW2_QUERY_UTILS_H
+#define AW2_QUERY_UTILS_H
+
+#include "alpha_wrap_2/types.h"
+#include "alpha_wrap_2/point_set_oracle_2.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace aw2 {
+    // Intersection of the segment (p, q) with the circle around center, closest to p with parameter in (0, 1]
+    bool segment_circle_intersection(const Point_2 &p, const Point_2 &q, const Point_2 &center, FT radius, Point_2 &o,
+                                     FT &lambda);
+
+    // Finishes a Rule 2 query from the candidate points (xs[i], ys[i]), which must contain all input points within
+    // distance R + offset_size of c, where R is the circumradius of the queried face.
+    // Sets the projection of c and the first intersection with the offset surface.
+    void finish_rule_2_query(const Point_2 &c, const std::vector<FT> &xs, const std::vector<FT> &ys,
+                             FT offset_size, Rule2Query &result);
+
+    // Radius of the disk around the circumcenter c of t that holds every candidate of a Rule 2 query,
+    // grown slightly to stay conservative under rounding
+    inline FT rule_2_query_radius(const K::Triangle_2 &t, const Point_2 &c, const FT offset_size) {
+        FT sq_radius = 0.0;
+        for (int i = 0; i < 3; ++i) {
+            sq_radius = std::max(sq_radius, CGAL::squared_distance(c, t.vertex(i)));
+        }
+        return (std::sqrt(sq_radius) + offset_size) * (1.0 + 1e-9);
+    }
+
+    // Squared distance of (x, y) to an axis-aligned box, 0 if it lies inside
+    inline FT squared_distance_to_box(const FT x, const FT y,
+                                      const FT xmin, const FT xmax, const FT ymin, const FT ymax) {
+        const FT dx = std::max({xmin - x, FT(0), x - xmax});
+        const FT dy = std::max({ymin - y, FT(0), y - ymax});
+        return dx * dx + dy * dy;
+    }
+
+    // Clips the segment p + t * (dx, dy), t in [0, t_max], against an axis-aligned box (Liang-Barsky).
+    // Returns false if they do not overlap, otherwise [t_enter, t_exit] is the parameter range inside the box.
+    inline bool clip_segment_to_box(const FT px, const FT py, const FT dx, const FT dy,
+                                    const FT xmin, const FT xmax, const FT ymin, const FT ymax,
+                                    const FT t_max, FT &t_enter, FT &t_exit) {
+        FT t0 = 0.0;
+        FT t1 = t_max;
+        const FT d[2] = {dx, dy};
+        const FT lo[2] = {xmin - px, ymin - py};
+        const FT hi[2] = {xmax - px, ymax - py};
+        for (int k = 0; k < 2; ++k) {
+            if (d[k] == 0) {
+                if (lo[k] > 0 || hi[k] < 0) return false;
+                continue;
+            }
+            FT ta = lo[k] / d[k];
+            FT tb = hi[k] / d[k];
+            if (ta > tb) std::swap(ta, tb);
+            t0 = std::max(t0, ta);
+            t1 = std::min(t1, tb);
+            if (t0 > t1) return false;
+        }
+        t_enter = t0;
+        t_exit = t1;
+        return true;
+    }
+
+    inline bool clip_segment_to_box(const FT px, const FT py, const FT dx, const FT dy,
+                                    const FT xmin, const FT xmax, const FT ymin, const FT ymax,
+                                    const FT t_max, FT &t_enter) {
+        FT t_exit;
+        return clip_segment_to_box(px, py, dx, dy, xmin, xmax, ymin, ymax, t_max, t_enter, t_exit);
+    }
+
+    // Strip of half width distance around the line through a segment, clipped to the bounding box of the
+    // segment grown by distance. It holds every point within distance of the segment and is grown slightly
+    // to stay conservative under rounding.
+    struct SegmentStrip {
+        FT sx, sy, dx, dy;
+        // bound on |cross((dx, dy), q - s)|
+        FT bound;
+        FT xmin, xmax, ymin, ymax;
+
+        SegmentStrip(const Segment_2 &seg, FT distance) {
+            distance *= 1.0 + 1e-9;
+            sx = seg.source().x();
+            sy = seg.source().y();
+            dx = seg.target().x() - sx;
+            dy = seg.target().y() - sy;
+            bound = distance * std::sqrt(dx * dx + dy * dy);
+            xmin = std::min(sx, sx + dx) - distance;
+            xmax = std::max(sx, sx + dx) + distance;
+            ymin = std::min(sy, sy + dy) - distance;
+            ymax = std::max(sy, sy + dy) + distance;
+        }
+
+        bool contains(const FT x, const FT y) const {
+            if (x < xmin || x > xmax || y < ymin || y > ymax) return false;
+            return std::abs(dx * (y - sy) - dy * (x - sx)) <= bound;
+        }
+
+        // false if the rectangle certainly does not overlap the strip
+        bool may_overlap(const FT rxmin, const FT rxmax, const FT rymin, const FT rymax) const {
+            if (rxmax < xmin || rxmin > xmax || rymax < ymin || rymin > ymax) return false;
+
+            // the cross product is linear, its extremes over the rectangle are at corners
+            const FT y_lo = dx * ((dx >= 0 ? rymin : rymax) - sy);
+            const FT y_hi = dx * ((dx >= 0 ? rymax : rymin) - sy);
+            const FT x_lo = -dy * ((dy <= 0 ? rxmin : rxmax) - sx);
+            const FT x_hi = -dy * ((dy <= 0 ? rxmax : rxmin) - sx);
+            return y_hi + x_hi >= -bound && y_lo + x_lo <= bound;
+        }
+    };
+
+    enum class RectTriangleRelation {
+        // no point of the rectangle lies strictly inside the triangle
+        OUTSIDE,
+        // every point of the rectangle lies strictly inside the triangle
+        INSIDE,
+        CROSSING
+    };
+
+    // Classifies an axis-aligned rectangle against a non-degenerate, counterclockwise oriented triangle.
+    // Only exact predicates are used, so pruning based on the result never misses a point.
+    inline RectTriangleRelation classify_rect(const K::Triangle_2 &t,
+                                              const FT xmin, const FT xmax, const FT ymin, const FT ymax) {
+        const Point_2 corners[4] = {{xmin, ymin}, {xmax, ymin}, {xmax, ymax}, {xmin, ymax}};
+
+        // all corners weakly outside of one of the edges
+        for (int i = 0; i < 3; ++i) {
+            const auto &a = t.vertex(i);
+            const auto &b = t.vertex(i + 1);
+            bool all_outside = true;
+            for (const auto &c: corners) {
+                if (CGAL::orientation(a, b, c) == CGAL::LEFT_TURN) {
+                    all_outside = false;
+                    break;
+                }
+            }
+            if (all_outside) return RectTriangleRelation::OUTSIDE;
+        }
+
+        // the triangle is convex, so it contains the rectangle if it contains all corners
+        for (const auto &c: corners) {
+            if (!t.has_on_bounded_side(c)) return RectTriangleRelation::CROSSING;
+        }
+        return RectTriangleRelation::INSIDE;
+    }
+}
+
+#endif // AW2_QUERY_UTILS_H
@@ -0,0 +1,72 @@
+#include "alpha_wrap_2/reachability_grid.h"
+
+#include <cmath>
+#include <limits>
+
+namespace aw2 {
+    bool ReachabilityGrid::build(const point_set_oracle_2 &oracle, const FT cell_size,
+                                 const std::size_t memory_budget) {
+        cells_.clear();
+        cell_size_ = 0.0;
+
+        const auto &bbox = oracle.bbox_;
+        const FT nx = std::ceil((bbox.x_max - bbox.x_min) / cell_size) + 3;
+        const FT ny = std::ceil((bbox.y_max - bbox.y_min) / cell_size) + 3;
+        const FT n_bytes = nx * ny * sizeof(CellState);
+        if (!(n_bytes < FT(std::numeric_limits<int>::max())) || (memory_budget > 0 && n_bytes > FT(memory_budget))) {
+            return false;
+        }
+
+        cell_size_ = cell_size;
+        x0_ = bbox.x_min - cell_size;
+        y0_ = bbox.y_min - cell_size;
+        nx_ = static_cast<int>(nx);
+        ny_ = static_cast<int>(ny);
+        cells_.assign(static_cast<std::size_t>(nx_) * ny_, FREE);
+        for (const auto &p: oracle.tree_) {
+            const int ix = static_cast<int>((p.x() - x0_) / cell_size);
+            const int iy = static_cast<int>((p.y() - y0_) / cell_size);
+            cells_[static_cast<std::size_t>(iy) * nx_ + ix] = OCCUPIED;
+        }
+
+        // flood fill from the margin, which is free
+        std::vector<std::size_t> stack;
+        const auto visit = [&](const int ix, const int iy) {
+            const std::size_t i = static_cast<std::size_t>(iy) * nx_ + ix;
+            if (cells_[i] != FREE) return;
+            cells_[i] = REACHED;
+            stack.push_back(i);
+        };
+        visit(0, 0);
+        while (!stack.empty()) {
+            const std::size_t i = stack.back();
+            stack.pop_back();
+            const int ix = static_cast<int>(i % nx_), iy = static_cast<int>(i / nx_);
+            if (ix > 0) visit(ix - 1, iy);
+            if (ix + 1 < nx_) visit(ix + 1, iy);
+            if (iy > 0) visit(ix, iy - 1);
+            if (iy + 1 < ny_) visit(ix, iy + 1);
+        }
+        return true;
+    }
+
+    ReachabilityGrid::CellState ReachabilityGrid::state(const Point_2 &p) const {
+        const FT fx = std::floor((p.x() - x0_) / cell_size_);
+        const FT fy = std::floor((p.y() - y0_) / cell_size_);
+        if (!(fx >= 0 && fx < nx_ && fy >= 0 && fy < ny_)) return REACHED;
+        return cells_[static_cast<std::size_t>(fy) * nx_ + static_cast<std::size_t>(fx)];
+    }
+
+    bool ReachabilityGrid::is_enclosed(const Delaunay &dt) const {
+        if (empty()) return false;
+
+        bool unreached = false;
+        for (auto fit = dt.finite_faces_begin(); fit != dt.finite_faces_end(); ++fit) {
+            if (fit->info() != OUTSIDE) continue;
+            const CellState s = state(CGAL::centroid(dt.triangle(fit)));
+            if (s == REACHED) return false;
+            unreached |= s == FREE;
+        }
+        return unreached;
+    }
+}
@@ -0,0 +1,138 @@
+#include "segment_circle_kernel.h"
+
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AW2_HAS_AVX2_KERNEL
+#endif
+
+namespace aw2 {
+    // The arithmetic follows segment_circle_intersection operation by operation, so all variants return
+    // exactly the same parameter.
+    bool first_segment_circle_hit_scalar(const FT px, const FT py, const FT qx, const FT qy,
+                                         const FT *xs, const FT *ys, const std::size_t n,
+                                         const FT radius, FT &t) {
+        const FT dx = qx - px;
+        const FT dy = qy - py;
+        const FT a = dx * dx + dy * dy;
+        if (a == 0) return false; // degenerate segment
+
+        const FT sq_radius = radius * radius;
+        const FT two_a = 2 * a;
+        const FT four_a = 4 * a;
+
+        bool found = false;
+        for (std::size_t i = 0; i < n; ++i) {
+            const FT ox = px - xs[i];
+            const FT oy = py - ys[i];
+            const FT b = 2 * (dx * ox + dy * oy);
+            const FT c = ox * ox + oy * oy - sq_radius;
+            const FT disc = b * b - four_a * c;
+            if (disc < 0) continue;
+
+            const FT sqrt_disc = std::sqrt(disc);
+            const FT t1 = (-b - sqrt_disc) / two_a;
+            const FT t2 = (-b + sqrt_disc) / two_a;
+
+            // t1 <= t2, so the first valid one is the smaller one
+            FT t_candidate;
+            if (t1 > 0.0 && t1 <= 1.0) t_candidate = t1;
+            else if (t2 > 0.0 && t2 <= 1.0) t_candidate = t2;
+            else continue;
+
+            if (t_candidate < t) {
+                t = t_candidate;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+#ifdef AW2_HAS_AVX2_KERNEL
+    __attribute__((target("avx2")))
+    static bool first_segment_circle_hit_avx2(const FT px, const FT py, const FT qx, const FT qy,
+                                              const FT *xs, const FT *ys, const std::size_t n,
+                                              const FT radius, FT &t) {
+        const FT dx = qx - px;
+        const FT dy = qy - py;
+        const FT a = dx * dx + dy * dy;
+        if (a == 0) return false; // degenerate segment
+
+        const __m256d v_px = _mm256_set1_pd(px);
+        const __m256d v_py = _mm256_set1_pd(py);
+        const __m256d v_dx = _mm256_set1_pd(dx);
+        const __m256d v_dy = _mm256_set1_pd(dy);
+        const __m256d v_sq_radius = _mm256_set1_pd(radius * radius);
+        const __m256d v_two_a = _mm256_set1_pd(2 * a);
+        const __m256d v_four_a = _mm256_set1_pd(4 * a);
+        const __m256d v_two = _mm256_set1_pd(2.0);
+        const __m256d v_zero = _mm256_setzero_pd();
+        const __m256d v_one = _mm256_set1_pd(1.0);
+        const __m256d v_none = _mm256_set1_pd(std::numeric_limits<FT>::max());
+        const __m256d v_sign = _mm256_set1_pd(-0.0);
+
+        __m256d v_best = v_none;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            const __m256d ox = _mm256_sub_pd(v_px, _mm256_loadu_pd(xs + i));
+            const __m256d oy = _mm256_sub_pd(v_py, _mm256_loadu_pd(ys + i));
+            const __m256d b = _mm256_mul_pd(v_two, _mm256_add_pd(_mm256_mul_pd(v_dx, ox), _mm256_mul_pd(v_dy, oy)));
+            const __m256d c = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(ox, ox), _mm256_mul_pd(oy, oy)), v_sq_radius);
+            const __m256d disc = _mm256_sub_pd(_mm256_mul_pd(b, b), _mm256_mul_pd(v_four_a, c));
+            const __m256d has_roots = _mm256_cmp_pd(disc, v_zero, _CMP_GE_OQ);
+
+            // lanes without roots compute sqrt of a negative number, they are masked out below
+            const __m256d sqrt_disc = _mm256_sqrt_pd(disc);
+            const __m256d neg_b = _mm256_xor_pd(b, v_sign);
+            const __m256d t1 = _mm256_div_pd(_mm256_sub_pd(neg_b, sqrt_disc), v_two_a);
+            const __m256d t2 = _mm256_div_pd(_mm256_add_pd(neg_b, sqrt_disc), v_two_a);
+
+            const __m256d t1_valid = _mm256_and_pd(_mm256_cmp_pd(t1, v_zero, _CMP_GT_OQ),
+                                                   _mm256_cmp_pd(t1, v_one, _CMP_LE_OQ));
+            const __m256d t2_valid = _mm256_and_pd(_mm256_cmp_pd(t2, v_zero, _CMP_GT_OQ),
+                                                   _mm256_cmp_pd(t2, v_one, _CMP_LE_OQ));
+
+            __m256d candidate = _mm256_blendv_pd(v_none, t2, t2_valid);
+            candidate = _mm256_blendv_pd(candidate, t1, t1_valid);
+            candidate = _mm256_blendv_pd(v_none, candidate, has_roots);
+            v_best = _mm256_min_pd(v_best, candidate);
+        }
+
+        alignas(32) FT lanes[4];
+        _mm256_store_pd(lanes, v_best);
+        FT best = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+
+        bool found = false;
+        if (best < t) {
+            t = best;
+            found = true;
+        }
+        if (i < n && first_segment_circle_hit_scalar(px, py, qx, qy, xs + i, ys + i, n - i, radius, t)) {
+            found = true;
+        }
+        return found;
+    }
+#endif
+
+    namespace {
+        using Kernel = bool (*)(FT, FT, FT, FT, const FT *, const FT *, std::size_t, FT, FT &);
+
+        Kernel select_kernel() {
+#ifdef AW2_HAS_AVX2_KERNEL
+            if (__builtin_cpu_supports("avx2")) {
+                return &first_segment_circle_hit_avx2;
+            }
+#endif
+            return &first_segment_circle_hit_scalar;
+        }
+    }
+
+    bool first_segment_circle_hit(const FT px, const FT py, const FT qx, const FT qy,
+                                  const FT *xs, const FT *ys, const std::size_t n,
+                                  const FT radius, FT &t) {
+        static const Kernel kernel = select_kernel();
+        return kernel(px, py, qx, qy, xs, ys, n, radius, t);
+    }
+}
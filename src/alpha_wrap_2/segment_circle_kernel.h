@@ -0,0 +1,24 @@
+// Batched segment-circle intersection used by the oracles
+#ifndef AW2_SEGMENT_CIRCLE_KERNEL_H
+#define AW2_SEGMENT_CIRCLE_KERNEL_H
+
+#include "alpha_wrap_2/types.h"
+
+#include <cstddef>
+
+namespace aw2 {
+    // For the circles of the given radius around (xs[i], ys[i]), computes the smallest parameter t in (0, 1] where
+    // the segment p + t * (q - p) crosses one of them, i.e. the minimum over segment_circle_intersection.
+    // If a circle is hit with a parameter smaller than t on input, t is updated and true is returned.
+    // Uses AVX2 if the CPU supports it (checked once at runtime) and a scalar loop otherwise.
+    bool first_segment_circle_hit(FT px, FT py, FT qx, FT qy,
+                                  const FT *xs, const FT *ys, std::size_t n,
+                                  FT radius, FT &t);
+
+    // Scalar reference implementation
+    bool first_segment_circle_hit_scalar(FT px, FT py, FT qx, FT qy,
+                                         const FT *xs, const FT *ys, std::size_t n,
+                                         FT radius, FT &t);
+}
+
+#endif // AW2_SEGMENT_CIRCLE_KERNEL_H
@@ -0,0 +1,285 @@
+#include "alpha_wrap_2/sharded_wrap_2.h"
+#include "alpha_wrap_2/timer.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace aw2 {
+    namespace {
+        // Result of a tile as sent from a worker to the parent: the index of the tile in the plan, its statistics and
+        // its edges as four coordinates each, in the native representation since both ends run on the same machine
+        class ByteWriter {
+        public:
+            template<class T>
+            void put(const T &value) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                const auto *bytes = reinterpret_cast<const char *>(&value);
+                buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+            }
+
+            const std::vector<char> &buffer() const { return buffer_; }
+
+            void clear() { buffer_.clear(); }
+
+        private:
+            std::vector<char> buffer_;
+        };
+
+        class ByteReader {
+        public:
+            explicit ByteReader(const std::vector<char> &buffer)
+                : pos_(buffer.data()), end_(buffer.data() + buffer.size()) {
+            }
+
+            bool done() const { return pos_ == end_; }
+
+            template<class T>
+            T get() {
+                static_assert(std::is_trivially_copyable_v<T>);
+                if (static_cast<std::size_t>(end_ - pos_) < sizeof(T)) {
+                    throw std::runtime_error("Truncated result from a worker process.");
+                }
+                T value;
+                std::memcpy(&value, pos_, sizeof(T));
+                pos_ += sizeof(T);
+                return value;
+            }
+
+        private:
+            const char *pos_;
+            const char *end_;
+        };
+
+        void write_tile(ByteWriter &out, const std::uint64_t index, const tiled_wrap_2::Tile &tile) {
+            const TileStats &s = tile.stats;
+            out.put(index);
+            for (const int v: {s.ix, s.iy, s.n_input_points, s.n_iterations, s.n_edges, s.n_enclosed_edges}) {
+                out.put(static_cast<std::int32_t>(v));
+            }
+            out.put(s.oracle_time);
+            out.put(s.total_time);
+            out.put(static_cast<std::uint64_t>(tile.edges.size()));
+            for (const auto &e: tile.edges) {
+                out.put(e.source().x());
+                out.put(e.source().y());
+                out.put(e.target().x());
+                out.put(e.target().y());
+            }
+        }
+
+        void read_tile(ByteReader &in, std::vector<tiled_wrap_2::Tile> &tiles, const int process) {
+            const auto index = in.get<std::uint64_t>();
+            if (index >= tiles.size()) {
+                throw std::runtime_error("Invalid tile index from a worker process.");
+            }
+            auto &tile = tiles[index];
+            TileStats &s = tile.stats;
+            for (int *v: {&s.ix, &s.iy, &s.n_input_points, &s.n_iterations, &s.n_edges, &s.n_enclosed_edges}) {
+                *v = in.get<std::int32_t>();
+            }
+            s.oracle_time = in.get<double>();
+            s.total_time = in.get<double>();
+            s.process = process;
+            const auto n_edges = in.get<std::uint64_t>();
+            tile.edges.clear();
+            tile.edges.reserve(n_edges);
+            for (std::uint64_t i = 0; i < n_edges; ++i) {
+                const auto sx = in.get<FT>(), sy = in.get<FT>(), tx = in.get<FT>(), ty = in.get<FT>();
+                tile.edges.emplace_back(Point_2(sx, sy), Point_2(tx, ty));
+            }
+        }
+
+        // after a failure: closes the read ends of the started workers, kills them and reaps them
+        void stop_workers(std::vector<pollfd> &pipes, const std::vector<pid_t> &pids) {
+            for (auto &p: pipes) {
+                if (p.fd >= 0) ::close(p.fd);
+                p.fd = -1;
+            }
+            for (const pid_t pid: pids) {
+                ::kill(pid, SIGKILL);
+            }
+            for (const pid_t pid: pids) {
+                while (::waitpid(pid, nullptr, 0) < 0 && errno == EINTR) {
+                }
+            }
+        }
+
+        bool write_all(const int fd, const char *data, std::size_t n) {
+            while (n > 0) {
+                const ssize_t written = ::write(fd, data, n);
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                data += written;
+                n -= static_cast<std::size_t>(written);
+            }
+            return true;
+        }
+    }
+
+    SharedPoints::SharedPoints(const Points &points) : size_(points.size()) {
+        n_bytes_ = std::max<std::size_t>(1, size_ * sizeof(Point_2));
+        void *data = ::mmap(nullptr, n_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) {
+            throw std::runtime_error("Failed to map " + std::to_string(n_bytes_) + " bytes: " + std::strerror(errno));
+        }
+        data_ = static_cast<Point_2 *>(data);
+        std::uninitialized_copy(points.begin(), points.end(), data_);
+    }
+
+    SharedPoints::~SharedPoints() {
+        std::destroy(data_, data_ + size_);
+        ::munmap(data_, n_bytes_);
+    }
+
+    sharded_wrap_2::sharded_wrap_2(const Oracle &oracle, const SharedPoints &points)
+        : tiled_(oracle), points_(points) {
+    }
+
+    void sharded_wrap_2::run(const AlgorithmConfig &config, const TilingConfig &tiling, const OracleParams &params,
+                             const int n_processes) {
+        Timer total_timer("Sharded Wrap");
+        total_timer.start();
+
+        std::vector<tiled_wrap_2::Tile> tiles = tiled_.plan(config, tiling, params);
+
+        const std::size_t n_workers = std::min<std::size_t>(
+            tiles.size(), n_processes > 0 ? n_processes : std::max(1u, std::thread::hardware_concurrency()));
+
+        // the tiles are sorted by decreasing point count, each goes to the worker with the fewest points so far
+        std::vector<std::vector<std::size_t> > assigned(n_workers);
+        std::vector<std::size_t> load(n_workers, 0);
+        for (std::size_t i = 0; i < tiles.size(); ++i) {
+            const std::size_t w = std::min_element(load.begin(), load.end()) - load.begin();
+            assigned[w].push_back(i);
+            load[w] += tiles[i].n_points;
+        }
+
+        OracleParams tile_params = params;
+        if (tile_params.memory_budget > 0) {
+            tile_params.memory_budget = std::max<std::size_t>(1, params.memory_budget / n_workers);
+        }
+
+        // Start the workers, the output of all workers still running is flushed so that it is not written twice
+        std::cout.flush();
+        std::cerr.flush();
+        std::vector<pid_t> pids;
+        std::vector<pollfd> pipes;
+        for (std::size_t w = 0; w < n_workers; ++w) {
+            int fds[2];
+            if (::pipe(fds) != 0) {
+                const std::string message = std::string("Failed to create a pipe: ") + std::strerror(errno);
+                stop_workers(pipes, pids);
+                throw std::runtime_error(message);
+            }
+            const pid_t pid = ::fork();
+            if (pid < 0) {
+                const std::string message = std::string("Failed to start a worker process: ") + std::strerror(errno);
+                ::close(fds[0]);
+                ::close(fds[1]);
+                stop_workers(pipes, pids);
+                throw std::runtime_error(message);
+            }
+
+            if (pid == 0) {
+                ::close(fds[0]);
+                for (const auto &p: pipes) ::close(p.fd);
+
+                int status = 0;
+                try {
+                    std::vector<tiled_wrap_2::Tile> own;
+                    for (const std::size_t i: assigned[w]) own.push_back(tiles[i]);
+                    tiled_.collect_points(points_.begin(), points_.end(), own);
+
+                    ByteWriter out;
+                    for (std::size_t k = 0; k < own.size(); ++k) {
+                        tiled_.wrap_tile(own[k], config, tile_params);
+                        out.clear();
+                        write_tile(out, assigned[w][k], own[k]);
+                        if (!write_all(fds[1], out.buffer().data(), out.buffer().size())) {
+                            throw std::runtime_error(std::string("Failed to send a tile: ") + std::strerror(errno));
+                        }
+                        own[k].edges = std::vector<Segment_2>();
+                    }
+                } catch (const std::exception &e) {
+                    std::cerr << "Worker process " << w + 1 << ": " << e.what() << std::endl;
+                    status = 1;
+                }
+                ::close(fds[1]);
+                std::cout.flush();
+                // skips the destructors of the state shared with the parent
+                ::_exit(status);
+            }
+
+            ::close(fds[1]);
+            pids.push_back(pid);
+            pipes.push_back({fds[0], POLLIN, 0});
+        }
+
+        // collect the results of all workers as they arrive, a pipe is done when its worker closed it
+        std::vector<std::vector<char> > results(n_workers);
+        std::size_t n_open = n_workers;
+        char chunk[1 << 16];
+        while (n_open > 0) {
+            if (::poll(pipes.data(), pipes.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                const std::string message = std::string("Failed to wait for the worker processes: ") +
+                                            std::strerror(errno);
+                stop_workers(pipes, pids);
+                throw std::runtime_error(message);
+            }
+            for (std::size_t w = 0; w < n_workers; ++w) {
+                if (pipes[w].fd < 0 || !(pipes[w].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+                const ssize_t n = ::read(pipes[w].fd, chunk, sizeof(chunk));
+                if (n > 0) {
+                    results[w].insert(results[w].end(), chunk, chunk + n);
+                } else if (n == 0 || errno != EINTR) {
+                    ::close(pipes[w].fd);
+                    pipes[w].fd = -1;
+                    --n_open;
+                }
+            }
+        }
+
+        // all pipes are closed, a worker that did not exit cleanly fails the run
+        std::string error;
+        for (std::size_t w = 0; w < n_workers; ++w) {
+            int status = 0;
+            while (::waitpid(pids[w], &status, 0) < 0 && errno == EINTR) {
+            }
+            if (error.empty() && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+                error = "Worker process " + std::to_string(w + 1) + " failed.";
+            }
+        }
+        if (!error.empty()) {
+            throw std::runtime_error(error);
+        }
+
+        for (std::size_t w = 0; w < n_workers; ++w) {
+            ByteReader in(results[w]);
+            while (!in.done()) {
+                read_tile(in, tiles, static_cast<int>(w + 1));
+            }
+            results[w] = std::vector<char>();
+        }
+
+        tiled_.statistics_.config.n_threads = 1;
+        tiled_.statistics_.n_processes = static_cast<int>(n_workers);
+        tiled_.finish(tiles, config, total_timer);
+    }
+}
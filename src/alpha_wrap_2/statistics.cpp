@@ -1,16 +1,38 @@
 #include <alpha_wrap_2/statistics.h>
 
+#include <fstream>
+#include <stdexcept>
+
 namespace aw2 {
     using json = nlohmann::json;
 
-    void AlgorithmStatistics::export_to_json(const std::string &filepath) const {
-        std::ofstream file(filepath);
-        if (!file.is_open()) {
-            throw std::runtime_error("Failed to open file for writing: " + filepath);
+    namespace {
+        template<class T>
+        void write_json(const T &statistics, const std::string &filepath) {
+            std::ofstream file(filepath);
+            if (!file.is_open()) {
+                throw std::runtime_error("Failed to open file for writing: " + filepath);
+            }
+
+            const json j = statistics;
+            file << j.dump(2);
+            file.close();
         }
+    }
+
+    void AlgorithmStatistics::export_to_json(const std::string &filepath) const {
+        write_json(*this, filepath);
+    }
+
+    void TiledStatistics::export_to_json(const std::string &filepath) const {
+        write_json(*this, filepath);
+    }
+
+    void ComponentWrapStatistics::export_to_json(const std::string &filepath) const {
+        write_json(*this, filepath);
+    }
 
-        const json j = *this;
-        file << j.dump(2);
-        file.close();
+    void BatchStatistics::export_to_json(const std::string &filepath) const {
+        write_json(*this, filepath);
     }
 } // namespace aw2
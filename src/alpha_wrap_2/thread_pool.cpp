@@ -0,0 +1,82 @@
+#include "alpha_wrap_2/thread_pool.h"
+
+namespace aw2 {
+    ThreadPool::ThreadPool(unsigned n_threads) {
+        if (n_threads == 0) {
+            n_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 1; i < n_threads; ++i) {
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto &worker: workers_) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::parallel_for(const std::size_t n, const std::function<void(std::size_t)> &fn) {
+        if (workers_.empty() || n <= 1) {
+            for (std::size_t i = 0; i < n; ++i) fn(i);
+            return;
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            task_ = &fn;
+            n_tasks_ = n;
+            next_task_ = 0;
+            n_active_ = workers_.size();
+            error_ = nullptr;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        run_tasks();
+
+        std::exception_ptr error;
+        {
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [this] { return n_active_ == 0; });
+            task_ = nullptr;
+            std::swap(error, error_);
+        }
+        if (error) std::rethrow_exception(error);
+    }
+
+    void ThreadPool::worker_loop() {
+        std::uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+            }
+
+            run_tasks();
+
+            std::lock_guard lock(mutex_);
+            if (--n_active_ == 0) done_.notify_one();
+        }
+    }
+
+    void ThreadPool::run_tasks() {
+        for (;;) {
+            const auto i = next_task_.fetch_add(1, std::memory_order_relaxed);
+            if (i >= n_tasks_) return;
+            try {
+                (*task_)(i);
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+            }
+        }
+    }
+}
@@ -0,0 +1,299 @@
+#include "alpha_wrap_2/tiled_wrap_2.h"
+#include "alpha_wrap_2/export_utils.h"
+#include "alpha_wrap_2/thread_pool.h"
+#include "alpha_wrap_2/timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+namespace aw2 {
+    namespace fs = std::filesystem;
+
+    tiled_wrap_2::tiled_wrap_2(const Oracle &oracle) : oracle_(oracle) {
+    }
+
+    int tiled_wrap_2::tile_x(const FT x) const {
+        return static_cast<int>(std::clamp(std::floor((x - x0_) / tile_size_), FT(0), FT(nx_ - 1)));
+    }
+
+    int tiled_wrap_2::tile_y(const FT y) const {
+        return static_cast<int>(std::clamp(std::floor((y - y0_) / tile_size_), FT(0), FT(ny_ - 1)));
+    }
+
+    void tiled_wrap_2::run(const AlgorithmConfig &config, const TilingConfig &tiling, const OracleParams &params) {
+        Timer total_timer("Tiled Wrap");
+        total_timer.start();
+
+        std::vector<Tile> tiles = plan(config, tiling, params);
+        collect_points(oracle_.tree_.begin(), oracle_.tree_.end(), tiles);
+
+        // largest tiles first, the pool hands out the next tile to whichever thread is done, so the small tiles
+        // at the end balance the load
+        ThreadPool pool(static_cast<unsigned>(std::max(0, tiling.n_threads)));
+        OracleParams tile_params = params;
+        if (tile_params.memory_budget > 0) {
+            tile_params.memory_budget = std::max<std::size_t>(1, params.memory_budget / pool.size());
+        }
+        pool.parallel_for(tiles.size(), [&](const std::size_t i) {
+            wrap_tile(tiles[i], config, tile_params);
+        });
+
+        statistics_.config.n_threads = static_cast<int>(pool.size());
+        statistics_.n_processes = 1;
+        finish(tiles, config, total_timer);
+    }
+
+    std::vector<tiled_wrap_2::Tile> tiled_wrap_2::plan(const AlgorithmConfig &config, const TilingConfig &tiling,
+                                                       const OracleParams &params) {
+        if (oracle_.empty()) {
+            throw std::invalid_argument("Cannot tile an empty input.");
+        }
+        if (!(tiling.tile_size_factor > 0) || tiling.overlap_factor < 0) {
+            throw std::invalid_argument("The tile size has to be positive and the overlap non-negative.");
+        }
+
+        const FT diag = oracle_.bbox_diagonal_length();
+        const FT scale = config.alpha * diag + config.offset * diag;
+        tile_size_ = tiling.tile_size_factor * scale;
+        overlap_ = tiling.overlap_factor * scale;
+        if (!(tile_size_ > 0)) {
+            throw std::invalid_argument("Tiling needs a positive alpha + offset.");
+        }
+
+        const auto &bbox = oracle_.bbox_;
+        x0_ = bbox.x_min;
+        y0_ = bbox.y_min;
+        nx_ = static_cast<int>(std::clamp(std::ceil((bbox.x_max - x0_) / tile_size_), FT(1), FT(1 << 20)));
+        ny_ = static_cast<int>(std::clamp(std::ceil((bbox.y_max - y0_) / tile_size_), FT(1), FT(1 << 20)));
+        local_field_ = tiling.local_field;
+
+        reachability_.build(oracle_, scale / 2, params.memory_budget);
+
+        // only tiles with input points are created
+        std::vector<Tile> tiles;
+        std::unordered_map<std::int64_t, std::size_t> tile_index;
+        for (const auto &p: oracle_.tree_) {
+            for_each_tile(p, [&](const int ix, const int iy) {
+                const auto [it, inserted] = tile_index.try_emplace(tile_key(ix, iy), tiles.size());
+                if (inserted) {
+                    tiles.emplace_back();
+                    tiles.back().ix = ix;
+                    tiles.back().iy = iy;
+                }
+                ++tiles[it->second].n_points;
+            });
+        }
+
+        std::sort(tiles.begin(), tiles.end(), [](const Tile &a, const Tile &b) {
+            if (a.n_points != b.n_points) return a.n_points > b.n_points;
+            return std::make_pair(a.iy, a.ix) < std::make_pair(b.iy, b.ix);
+        });
+        return tiles;
+    }
+
+    void tiled_wrap_2::finish(const std::vector<Tile> &tiles, const AlgorithmConfig &config, Timer &total_timer) {
+        Timer stitching_timer("Stitching");
+        stitching_timer.start();
+        stitch_seams(tiles, 2 * config.alpha * oracle_.bbox_diagonal_length());
+        stitching_timer.pause();
+
+        total_timer.pause();
+
+        // Collect statistics, the configuration is the one of the whole input
+        fill_config_stats(config, statistics_.config);
+        statistics_.tile_size = tile_size_;
+        statistics_.tile_overlap = overlap_;
+        statistics_.n_tiles_x = nx_;
+        statistics_.n_tiles_y = ny_;
+        statistics_.reachability_cell_size = reachability_.cell_size();
+        statistics_.n_edges = static_cast<int>(wrap_edges_.size());
+        statistics_.total_time = total_timer.elapsed_ms();
+        statistics_.stitching_time = stitching_timer.elapsed_ms();
+        statistics_.tiles.clear();
+        for (const auto &tile: tiles) {
+            statistics_.tiles.push_back(tile.stats);
+        }
+
+        try {
+            fs::create_directories(config.output_directory);
+        } catch (const fs::filesystem_error &e) {
+            throw std::runtime_error("Failed to create directory: " + std::string(e.what()));
+        }
+        export_wrap_edges(wrap_edges_, (fs::path(config.output_directory) / "wrap_edges.txt").string());
+        statistics_.export_to_json((fs::path(config.output_directory) / "statistics.json").string());
+    }
+
+    void tiled_wrap_2::wrap_tile(Tile &tile, const AlgorithmConfig &config, const OracleParams &params) const {
+        tile.stats.ix = tile.ix;
+        tile.stats.iy = tile.iy;
+        tile.stats.n_input_points = static_cast<int>(tile.points.size());
+        if (tile.points.empty()) return;
+
+        Timer oracle_timer("Tile Oracle");
+        oracle_timer.start();
+        Oracle oracle;
+        oracle.add_point_set(tile.points);
+        Points().swap(tile.points);
+        oracle.prepare(params);
+        if (local_field_) {
+            oracle.build_local_geometry_field(params);
+        }
+        oracle_timer.pause();
+        tile.stats.oracle_time = oracle_timer.elapsed_ms();
+
+        // alpha_wrap_2 needs a bounding box of positive size, a tile whose points all coincide is left empty
+        const FT diag = oracle.bbox_diagonal_length();
+        if (!(diag > 0)) return;
+
+        // the relative parameters refer to the bounding box of the tile, rescale them to keep the absolute values
+        AlgorithmConfig tile_config = rescaled_config(config, oracle_.bbox_diagonal_length() / diag);
+        // tiles are the unit of parallelism, and only the final result of a tile is exported
+        tile_config.n_threads = 1;
+        tile_config.export_step_limit = 0;
+        tile_config.print_report = false;
+        tile_config.output_directory = (fs::path(config.output_directory) / "tiles" /
+                                        ("tile_" + std::to_string(tile.ix) + "_" + std::to_string(tile.iy))).string();
+
+        alpha_wrap_2 aw(oracle);
+        aw.init(tile_config);
+        aw.run();
+
+        // Split the OUTSIDE faces around the core into components, the cut at the tile border is excluded by
+        // stopping at half the overlap. A component that only reaches empty cells not reached by the flood fill
+        // is enclosed by the input. Faces within input cells are undecided, so are components without any.
+        const Delaunay &dt = aw.dt_;
+        const FT inf = std::numeric_limits<FT>::infinity();
+        const FT zone = overlap_ / 2;
+        const FT zx_min = tile.ix == 0 ? -inf : x0_ + tile.ix * tile_size_ - zone;
+        const FT zx_max = tile.ix == nx_ - 1 ? inf : x0_ + (tile.ix + 1) * tile_size_ + zone;
+        const FT zy_min = tile.iy == 0 ? -inf : y0_ + tile.iy * tile_size_ - zone;
+        const FT zy_max = tile.iy == ny_ - 1 ? inf : y0_ + (tile.iy + 1) * tile_size_ + zone;
+        const auto in_zone = [&](const Delaunay::Face_handle &f) {
+            if (dt.is_infinite(f)) return false;
+            const Point_2 c = CGAL::centroid(dt.triangle(f));
+            return zx_min <= c.x() && c.x() <= zx_max && zy_min <= c.y() && c.y() <= zy_max;
+        };
+
+        std::unordered_map<const void *, std::size_t> component;
+        std::vector<bool> enclosed;
+        if (!reachability_.empty()) {
+            std::vector<Delaunay::Face_handle> stack;
+            for (auto fit = dt.finite_faces_begin(); fit != dt.finite_faces_end(); ++fit) {
+                const Delaunay::Face_handle f0 = fit;
+                if (f0->info() != OUTSIDE || component.count(&*f0) || !in_zone(f0)) continue;
+
+                const std::size_t id = enclosed.size();
+                bool reached = false, unreached = false;
+                component.emplace(&*f0, id);
+                stack.push_back(f0);
+                while (!stack.empty()) {
+                    const auto f = stack.back();
+                    stack.pop_back();
+                    const auto state = reachability_.state(CGAL::centroid(dt.triangle(f)));
+                    reached |= state == ReachabilityGrid::REACHED;
+                    unreached |= state == ReachabilityGrid::FREE;
+                    for (int i = 0; i < 3; ++i) {
+                        const auto n = f->neighbor(i);
+                        if (n->info() != OUTSIDE || !in_zone(n)) continue;
+                        if (component.emplace(&*n, id).second) stack.push_back(n);
+                    }
+                }
+                enclosed.push_back(unreached && !reached);
+            }
+        }
+
+        for (auto eit = dt.finite_edges_begin(); eit != dt.finite_edges_end(); ++eit) {
+            const auto f = eit->first;
+            const auto n = f->neighbor(eit->second);
+            if (f->info() == n->info()) continue;
+
+            const Segment_2 e = dt.segment(*eit);
+            const Point_2 m = CGAL::midpoint(e.source(), e.target());
+            if (tile_x(m.x()) != tile.ix || tile_y(m.y()) != tile.iy) continue;
+
+            const auto it = component.find(f->info() == OUTSIDE ? &*f : &*n);
+            if (it != component.end() && enclosed[it->second]) {
+                ++tile.stats.n_enclosed_edges;
+                continue;
+            }
+            tile.edges.push_back(e);
+        }
+
+        const auto &stats = aw.get_statistics();
+        tile.stats.n_iterations = stats.execution_stats.n_iterations;
+        tile.stats.n_edges = static_cast<int>(tile.edges.size());
+        tile.stats.total_time = stats.timings.total_time;
+    }
+
+    void tiled_wrap_2::stitch_seams(const std::vector<Tile> &tiles, const FT max_length) {
+        struct Endpoint {
+            int degree = 0;
+            std::size_t tile = 0;
+        };
+
+        // the wraps of neighboring tiles often agree at the seam, their edges then share endpoints exactly
+        wrap_edges_.clear();
+        std::map<std::pair<FT, FT>, Endpoint> endpoints;
+        for (std::size_t t = 0; t < tiles.size(); ++t) {
+            for (const auto &e: tiles[t].edges) {
+                wrap_edges_.push_back(e);
+                for (const auto &p: {e.source(), e.target()}) {
+                    auto &ep = endpoints[{p.x(), p.y()}];
+                    ++ep.degree;
+                    ep.tile = t;
+                }
+            }
+        }
+
+        std::vector<std::pair<Point_2, std::size_t> > open;
+        for (const auto &[xy, ep]: endpoints) {
+            if (ep.degree == 1) open.emplace_back(Point_2(xy.first, xy.second), ep.tile);
+        }
+
+        // otherwise connect the closest pairs of open endpoints of different tiles, bucketed by cells of side
+        // max_length so that only the neighboring cells have to be searched
+        const FT sq_max_length = max_length * max_length;
+        const auto cell = [&](const Point_2 &p) {
+            return std::make_pair(static_cast<std::int64_t>(std::floor((p.x() - x0_) / max_length)),
+                                  static_cast<std::int64_t>(std::floor((p.y() - y0_) / max_length)));
+        };
+        std::map<std::pair<std::int64_t, std::int64_t>, std::vector<std::size_t> > cells;
+        for (std::size_t i = 0; i < open.size(); ++i) {
+            cells[cell(open[i].first)].push_back(i);
+        }
+
+        std::vector<std::tuple<FT, std::size_t, std::size_t> > candidates;
+        for (std::size_t i = 0; i < open.size(); ++i) {
+            const auto [cx, cy] = cell(open[i].first);
+            for (std::int64_t dy = -1; dy <= 1; ++dy) {
+                for (std::int64_t dx = -1; dx <= 1; ++dx) {
+                    const auto it = cells.find({cx + dx, cy + dy});
+                    if (it == cells.end()) continue;
+                    for (const std::size_t j: it->second) {
+                        if (j <= i || open[j].second == open[i].second) continue;
+                        const FT sq_dist = CGAL::squared_distance(open[i].first, open[j].first);
+                        if (sq_dist <= sq_max_length) candidates.emplace_back(sq_dist, i, j);
+                    }
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        std::vector<bool> connected(open.size(), false);
+        statistics_.n_seam_edges = 0;
+        for (const auto &[sq_dist, i, j]: candidates) {
+            if (connected[i] || connected[j]) continue;
+            connected[i] = connected[j] = true;
+            wrap_edges_.emplace_back(open[i].first, open[j].first);
+            ++statistics_.n_seam_edges;
+        }
+        statistics_.n_open_endpoints = static_cast<int>(std::count(connected.begin(), connected.end(), false));
+    }
+}
@@ -1,6 +1,65 @@
 #include "alpha_wrap_2/traversability.h"
 
+#include <functional>
+#include <limits>
+
 namespace aw2 {
+    std::size_t TraversabilityCache::VertexPairHash::operator()(const VertexPair &p) const {
+        const std::hash<const void *> h;
+        const std::size_t seed = h(&*p.first);
+        return seed ^ (h(&*p.second) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    }
+
+    bool TraversabilityCache::find(const Delaunay::Vertex_handle &v1, const Delaunay::Vertex_handle &v2,
+                                   FT &sq_threshold) {
+        const VertexPair key(v1, v2);
+        auto &s = shard(key);
+        std::lock_guard lock(s.mutex);
+        const auto it = s.entries.find(key);
+        if (it == s.entries.end()) {
+            s.n_misses++;
+            return false;
+        }
+        s.n_hits++;
+        sq_threshold = it->second;
+        return true;
+    }
+
+    void TraversabilityCache::insert(const Delaunay::Vertex_handle &v1, const Delaunay::Vertex_handle &v2,
+                                     const FT sq_threshold) {
+        const VertexPair key(v1, v2);
+        auto &s = shard(key);
+        std::lock_guard lock(s.mutex);
+        s.entries.emplace(key, sq_threshold);
+    }
+
+    void TraversabilityCache::clear() {
+        for (auto &s: shards_) {
+            std::lock_guard lock(s.mutex);
+            s.entries.clear();
+            s.n_hits = 0;
+            s.n_misses = 0;
+        }
+    }
+
+    std::size_t TraversabilityCache::n_hits() const {
+        std::size_t n = 0;
+        for (const auto &s: shards_) {
+            std::lock_guard lock(s.mutex);
+            n += s.n_hits;
+        }
+        return n;
+    }
+
+    std::size_t TraversabilityCache::n_misses() const {
+        std::size_t n = 0;
+        for (const auto &s: shards_) {
+            std::lock_guard lock(s.mutex);
+            n += s.n_misses;
+        }
+        return n;
+    }
+
     std::pair<Delaunay::Vertex_handle, Delaunay::Vertex_handle> Gate::get_vertices() const {
         auto v_target = edge.first->vertex(edge.first->cw(edge.second));
         auto v_source = edge.first->vertex(edge.first->ccw(edge.second));
@@ -14,49 +73,196 @@ namespace aw2 {
     }
 
     bool DeviationBasedTraversability::operator()(Gate &g) {
+        // keyed by the ordered vertex pair, the sub-segments are sampled from the source, so the deviation of
+        // the reversed gate can differ in the last bits
+        FT sq_adaptive_alpha;
+        if (cache_ && cache_->find(g.key.source, g.key.target, sq_adaptive_alpha)) {
+            return g.sq_min_delaunay_rad >= sq_adaptive_alpha;
+        }
+
         auto [fst, snd] = g.get_points();
         const Segment_2 seg(fst, snd);
+        if (field_) {
+            if (bool traversable; field_decides(seg, g.sq_min_delaunay_rad, traversable)) {
+                n_field_decisions_.fetch_add(1, std::memory_order_relaxed);
+                return traversable;
+            }
+            n_field_refinements_.fetch_add(1, std::memory_order_relaxed);
+        }
+
         const auto dev = segment_deviation(seg);
         const auto adaptive_alpha = alpha_max_ * (1 - dev) + alpha_ * dev;
-        return g.sq_min_delaunay_rad >= std::pow(adaptive_alpha, 2);
+        sq_adaptive_alpha = std::pow(adaptive_alpha, 2);
+        if (cache_) cache_->insert(g.key.source, g.key.target, sq_adaptive_alpha);
+        return g.sq_min_delaunay_rad >= sq_adaptive_alpha;
     }
 
-    FT DeviationBasedTraversability::subsegment_deviation(const Segment_2 &seg) const {
-        auto local_pts = oracle_.local_points(seg, 1.1 * offset_);
-        int n = local_pts.size();
-
+    FT DeviationBasedTraversability::subsegment_deviation(const int n, const FT sum_sq_deviation) const {
         // not enough points to compute a meaningful adaptive alpha
         if (n < point_threshold_) {
             return 1.0;
         }
 
-        // compute average squared deviation from the segment
-        auto avg_sq_deviation = 0.0;
-        for (const auto &pt: local_pts) {
-            avg_sq_deviation += CGAL::squared_distance(seg, pt);
-        }
-
-        avg_sq_deviation /= n;
+        // average squared deviation from the segment
+        const auto avg_sq_deviation = sum_sq_deviation / n;
         auto dev = deviation_factor_ * std::abs((avg_sq_deviation - std::pow(offset_, 2)));
         dev = std::clamp(dev, 0.0, 1.0);
 
         return dev;
     }
 
+    bool DeviationBasedTraversability::field_decides(const Segment_2 &seg, const FT sq_radius,
+                                                     bool &traversable) const {
+        // same sub-segments and boxes as segment_deviation
+        int m = std::ceil(std::sqrt(seg.squared_length()) / alpha_);
+        if (m <= 0) return false;
+
+        const auto s = seg.source();
+        const auto t = seg.target();
+        const FT margin = 1.1 * offset_;
+        const FT sq_offset = std::pow(offset_, 2);
+
+        // interval of the maximal sub-segment deviation
+        FT max_dev_lo = 0.0;
+        FT max_dev_hi = 0.0;
+        auto a = s;
+        for (int i = 1; i <= m; ++i) {
+            const auto b = s + (static_cast<FT>(i) / m) * (t - s);
+            const auto bounds = field_->box_deviation_bounds(
+                a.x(), a.y(), b.x(), b.y(),
+                std::min(a.x(), b.x()) - margin, std::max(a.x(), b.x()) + margin,
+                std::min(a.y(), b.y()) - margin, std::max(a.y(), b.y()) + margin);
+            a = b;
+
+            const auto threshold = static_cast<std::size_t>(std::max(point_threshold_, 1));
+            FT dev_lo, dev_hi;
+            if (bounds.n_upper < threshold) {
+                dev_lo = dev_hi = 1.0;
+            } else {
+                // average squared deviation if the sub-segment has enough points
+                const FT avg_lo = bounds.sum_lower / static_cast<FT>(bounds.n_upper);
+                const FT avg_hi = bounds.sum_upper / static_cast<FT>(std::max(bounds.n_lower, threshold));
+                const auto dev = [&](const FT avg) {
+                    return std::clamp(deviation_factor_ * std::abs(avg - sq_offset), 0.0, 1.0);
+                };
+                dev_lo = avg_lo <= sq_offset && sq_offset <= avg_hi ? 0.0 : std::min(dev(avg_lo), dev(avg_hi));
+                dev_hi = std::max(dev(avg_lo), dev(avg_hi));
+                if (bounds.n_lower < threshold) dev_hi = 1.0;
+            }
+            max_dev_lo = std::max(max_dev_lo, dev_lo);
+            max_dev_hi = std::max(max_dev_hi, dev_hi);
+        }
+
+        // the adaptive alpha is linear in the deviation
+        const FT alpha_lo = alpha_max_ * (1 - max_dev_lo) + alpha_ * max_dev_lo;
+        const FT alpha_hi = alpha_max_ * (1 - max_dev_hi) + alpha_ * max_dev_hi;
+        const FT sq_max = std::max(alpha_lo * alpha_lo, alpha_hi * alpha_hi);
+        const FT sq_min = (alpha_lo <= 0) != (alpha_hi <= 0)
+                              ? 0.0
+                              : std::min(alpha_lo * alpha_lo, alpha_hi * alpha_hi);
+
+        // relative slack for the rounding of the exact evaluation
+        if (sq_radius >= sq_max * (1 + 1e-9)) {
+            traversable = true;
+            return true;
+        }
+        if (sq_radius < sq_min * (1 - 1e-9)) {
+            traversable = false;
+            return true;
+        }
+        return false;
+    }
+
     FT DeviationBasedTraversability::segment_deviation(const Segment_2 &seg) const {
         auto segment_length = alpha_;
         int m = std::ceil(std::sqrt(seg.squared_length()) / segment_length);
-        auto s = seg.source();
-        auto t = seg.target();
+        if (m <= 0) return 0.0;
+
+        const auto s = seg.source();
+        const auto t = seg.target();
+        const FT margin = 1.1 * offset_;
+
+        // endpoints of the m sub-segments, computed as s + t0 * (t - s) like the sub-segments themselves
+        thread_local std::vector<FT> sub_x, sub_y;
+        sub_x.resize(m + 1);
+        sub_y.resize(m + 1);
+        for (int i = 0; i <= m; ++i) {
+            const auto p = s + (static_cast<FT>(i) / m) * (t - s);
+            sub_x[i] = p.x();
+            sub_y[i] = p.y();
+        }
+
+        // A point in the box of a sub-segment (its bounding box grown by margin) is within sqrt(2) * margin
+        // of the bounding box, whose points are within |dx * dy| / length of the sub-segment. One query for
+        // the whole gate returns all candidates of all sub-segments.
+        const FT dx = (t.x() - s.x()) / m;
+        const FT dy = (t.y() - s.y()) / m;
+        const FT sub_length = std::sqrt(dx * dx + dy * dy);
+        const FT reach = std::sqrt(2.0) * margin;
+        thread_local std::vector<FT> xs, ys;
+        oracle_.points_near_segment(seg, reach + std::abs(dx * dy) / sub_length, xs, ys);
+
+        // Sort the candidates by the sub-segment their projection falls into. A point can only lie in the boxes
+        // of sub-segments at most `window` away from it.
+        const FT inv_sq_length = 1.0 / (sub_length * sub_length);
+        const int window = static_cast<int>(std::ceil(reach / sub_length)) + 1;
+        thread_local std::vector<int> bucket;
+        thread_local std::vector<std::size_t> bucket_start;
+        thread_local std::vector<FT> sorted_x, sorted_y;
+        bucket.resize(xs.size());
+        bucket_start.assign(m + 1, 0);
+        for (std::size_t j = 0; j < xs.size(); ++j) {
+            const FT u = ((xs[j] - s.x()) * dx + (ys[j] - s.y()) * dy) * inv_sq_length;
+            bucket[j] = std::clamp(static_cast<int>(std::floor(u)), 0, m - 1);
+            bucket_start[bucket[j] + 1]++;
+        }
+        for (int i = 0; i < m; ++i) {
+            bucket_start[i + 1] += bucket_start[i];
+        }
+        sorted_x.resize(xs.size());
+        sorted_y.resize(xs.size());
+        for (std::size_t j = 0; j < xs.size(); ++j) {
+            const auto k = bucket_start[bucket[j]]++;
+            sorted_x[k] = xs[j];
+            sorted_y[k] = ys[j];
+        }
+        // bucket_start[i] is now the end of bucket i
+        for (int i = m; i > 0; --i) {
+            bucket_start[i] = bucket_start[i - 1];
+        }
+        bucket_start[0] = 0;
 
         auto max_dev = 0.0;
         for (int i = 0; i < m; ++i) {
-            FT t0 = static_cast<FT>(i) / m;
-            FT t1 = static_cast<FT>(i + 1) / m;
-            auto p0 = s + t0 * (t - s);
-            auto p1 = s + t1 * (t - s);
-            Segment_2 sub_seg(p0, p1);
-            if (const auto dev = subsegment_deviation(sub_seg); dev > max_dev) {
+            const FT ax = sub_x[i], ay = sub_y[i];
+            const FT bx = sub_x[i + 1], by = sub_y[i + 1];
+            const FT xmin = std::min(ax, bx) - margin, xmax = std::max(ax, bx) + margin;
+            const FT ymin = std::min(ay, by) - margin, ymax = std::max(ay, by) + margin;
+            const FT ux = bx - ax, uy = by - ay;
+            const FT sq_length = ux * ux + uy * uy;
+
+            // branch-free accumulation over the candidates of the neighboring buckets
+            const auto begin = bucket_start[std::max(0, i - window)];
+            const auto end = bucket_start[std::min(m, i + window + 1)];
+            int n = 0;
+            FT sum_sq_deviation = 0.0;
+            for (auto j = begin; j < end; ++j) {
+                const FT wx = sorted_x[j] - ax, wy = sorted_y[j] - ay;
+                const FT dot = wx * ux + wy * uy;
+                const FT cross = ux * wy - uy * wx;
+                const FT vx = sorted_x[j] - bx, vy = sorted_y[j] - by;
+                const FT sq_dist = dot <= 0
+                                       ? wx * wx + wy * wy
+                                       : dot >= sq_length
+                                             ? vx * vx + vy * vy
+                                             : cross * cross / sq_length;
+                const bool inside = sorted_x[j] >= xmin && sorted_x[j] <= xmax &&
+                                    sorted_y[j] >= ymin && sorted_y[j] <= ymax;
+                n += inside;
+                sum_sq_deviation += inside ? sq_dist : 0.0;
+            }
+
+            if (const auto dev = subsegment_deviation(n, sum_sq_deviation); dev > max_dev) {
                 max_dev = dev;
             }
         }
@@ -65,22 +271,63 @@ namespace aw2 {
     }
 
     bool IntersectionBasedTraversability::operator()(Gate &g) {
+        // the verdict does not depend on the radius, it is stored as threshold 0 (traversable) or infinity.
+        // The test direction depends on the orientation of the gate, so the key is the ordered vertex pair.
+        FT sq_threshold;
+        if (cache_ && cache_->find(g.key.source, g.key.target, sq_threshold)) {
+            return g.sq_min_delaunay_rad >= sq_threshold;
+        }
+
         auto [fst, snd] = g.get_points();
-        Point_2 s = fst;
-        Point_2 t = snd;
+        bool traversable;
+        if (field_ && field_clears(fst, snd)) {
+            n_field_decisions_.fetch_add(1, std::memory_order_relaxed);
+            traversable = true;
+        } else {
+            if (field_) n_field_refinements_.fetch_add(1, std::memory_order_relaxed);
+            traversable = deviates(fst, snd);
+        }
+        if (cache_) {
+            cache_->insert(g.key.source, g.key.target, traversable ? 0 : std::numeric_limits<FT>::infinity());
+        }
+        return traversable;
+    }
+
+    bool IntersectionBasedTraversability::field_clears(const Point_2 &s, const Point_2 &t) const {
+        // A sample without input points within offset + tolerance is outside the offset surface and its normal
+        // segment of length tolerance cannot reach it, deviates() stops at such a sample.
+        const FT clearance = (offset_ + tolerance_) * (1 + 1e-6);
+        int m = std::ceil(std::sqrt(CGAL::squared_distance(s, t)) / alpha_);
+        for (int i = 1; i < m; ++i) {
+            const Point_2 p0 = s + (static_cast<FT>(i) / m) * (t - s);
+            if (field_->distance_lower_bound(p0.x(), p0.y()) > clearance) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool IntersectionBasedTraversability::deviates(const Point_2 &s, const Point_2 &t) const {
         const CGAL::Line_2<K> line(s, t);
 
         // determine the number of samples based on alpha
         auto segment_length = alpha_;
         int m = std::ceil(std::sqrt(CGAL::squared_distance(s, t)) / segment_length);
 
+        // the sides of all samples are answered in one batch, consecutive samples share most of the search
+        thread_local std::vector<Point_2> samples;
+        thread_local std::vector<bool> outside;
+        samples.clear();
+        for (int i = 1; i < m; ++i) {
+            samples.push_back(s + (static_cast<FT>(i) / m) * (t - s));
+        }
+        oracle_.outside_offset(samples, offset_, outside);
+
         // perform offset surface intersection tests at m-1 evenly spaced samples along the edge
         for (int i = 1; i < m; ++i) {
-            FT t0 = static_cast<FT>(i) / m;
-            Point_2 p0 = s + t0 * (t - s);
+            const Point_2 &p0 = samples[i - 1];
 
-            auto input_dist_sq = CGAL::squared_distance(p0, oracle_.closest_point(p0));
-            auto sign = (input_dist_sq >= std::pow(offset_, 2)) ? 1 : -1;
+            auto sign = outside[i - 1] ? 1 : -1;
 
             // check for intersection along the normal direction,
             // tolerance_ determines the length of the segment (p0, p1)
@@ -1,5 +1,10 @@
 #include <alpha_wrap_2/alpha_wrap_2.h>
+#include <alpha_wrap_2/batch_wrap_2.h>
+#include <alpha_wrap_2/component_wrap_2.h>
 #include <alpha_wrap_2/export_utils.h>
+#include <alpha_wrap_2/point_order.h>
+#include <alpha_wrap_2/sharded_wrap_2.h>
+#include <alpha_wrap_2/tiled_wrap_2.h>
 #include <alpha_wrap_2/types.h>
 
 #include <CGAL/optimal_bounding_box.h>
@@ -7,6 +12,8 @@
 #include <string>
 #include <iostream>
 #include <algorithm>
+#include <memory>
+#include <stdexcept>
 
 struct bounding_box {
     aw2::Point_2 min_min;
@@ -32,10 +39,27 @@ void print_usage(const char *program_name) {
     std::cout << "Usage: " << program_name << " [OPTIONS]\n"
             << "Options:\n"
             << "  --input <file>     Input file path \n"
+            << "  --batch <manifest>   Wrap many inputs on --threads threads (directory, glob pattern or JSON list)\n"
             << "  --alpha <value>    Alpha value\n"
             << "  --offset <value>   Offset value\n"
             << "  --traversability <method>   Traversability method (CONSTANT_ALPHA, DEVIATION_BASED, INTERSECTION_BASED)\n"
+            << "  --queue_update <mode>   Queue update after Steiner point insertion (FULL_RESCAN, INCREMENTAL)\n"
+            << "  --queue <type>     Gate schedule (PRIORITY_QUEUE, STACK_QUEUE, BUCKET_QUEUE, DARY_HEAP)\n"
+            << "  --alternative_trav <true|false>   Modified alpha traversability (default set at build time)\n"
+            << "  --traversability_cache <true|false>   Memoize adaptive traversability per vertex pair (default true)\n"
+            << "  --threads <count>  Threads for evaluating gates (0 = all hardware threads)\n"
+            << "  --batch_insertion <count>   Steiner points inserted together per round (default 1)\n"
+            << "  --speculative_gates <count>   Gates whose rules are evaluated concurrently per round (default 1)\n"
             << "  --style <style>    Visualization style (default, clean, outside_filled)\n"
+            << "  --field_budget <MB>   Memory budget of the distance field oracle\n"
+            << "  --field_verify     Check the distance field oracle against the exact queries\n"
+            << "  --local_field      Precompute the local geometry field for the adaptive traversability\n"
+            << "  --point_order <order>   Reorder the input along a space-filling curve (FILE, MORTON, HILBERT)\n"
+            << "  --tiled            Wrap overlapping tiles independently on --threads threads and stitch them\n"
+            << "  --tile_size <factor>   Side length of the tiles in multiples of alpha + offset (default 64)\n"
+            << "  --tile_overlap <factor>   Overlap of the tiles in multiples of alpha + offset (default 4)\n"
+            << "  --processes <count>   Wrap the tiles of --tiled in forked worker processes (0 = one per thread)\n"
+            << "  --components       Wrap the offset-connected components separately on --threads threads\n"
             << "  --help             Show this help message\n";
 }
 
@@ -52,9 +76,10 @@ int main(int argc, char *argv[]) {
     aw2::AlgorithmConfig config;
 
 
+    const std::string batch_arg = get_cmd_option(argv, argv + argc, "--batch");
     if (std::string input_arg = get_cmd_option(argv, argv + argc, "--input"); !input_arg.empty()) {
         filename = input_arg;
-    } else {
+    } else if (batch_arg.empty()) {
         std::cerr << "Error: No input file specified. Use --input <file> to specify the input point set." << std::endl;
         return 1;
     }
@@ -114,6 +139,50 @@ int main(int argc, char *argv[]) {
         config.traversability_method = traversability_method;
     }
 
+    if (std::string queue_update_arg = get_cmd_option(argv, argv + argc, "--queue_update"); !queue_update_arg.
+        empty()) {
+        if (queue_update_arg == "FULL_RESCAN") {
+            config.queue_update_mode = aw2::FULL_RESCAN;
+        } else if (queue_update_arg == "INCREMENTAL") {
+            config.queue_update_mode = aw2::INCREMENTAL;
+        } else {
+            std::cerr << "Unknown queue update mode: " << queue_update_arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (std::string queue_arg = get_cmd_option(argv, argv + argc, "--queue"); !queue_arg.empty()) {
+        try {
+            config.queue_type = aw2::queue_type_from_name(queue_arg);
+        } catch (const std::invalid_argument &) {
+            std::cerr << "Unknown queue type: " << queue_arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (std::string alternative_trav_arg = get_cmd_option(argv, argv + argc, "--alternative_trav"); !
+        alternative_trav_arg.empty()) {
+        config.modified_alpha_traversability = alternative_trav_arg == "true";
+    }
+
+    if (std::string traversability_cache_arg = get_cmd_option(argv, argv + argc, "--traversability_cache"); !
+        traversability_cache_arg.empty()) {
+        config.traversability_cache = traversability_cache_arg == "true";
+    }
+
+    if (std::string threads_arg = get_cmd_option(argv, argv + argc, "--threads"); !threads_arg.empty()) {
+        config.n_threads = std::stoi(threads_arg);
+    }
+
+    if (std::string batch_insertion_arg = get_cmd_option(argv, argv + argc, "--batch_insertion"); !
+        batch_insertion_arg.empty()) {
+        config.batch_insertion = std::stoi(batch_insertion_arg);
+    }
+
+    if (std::string speculative_gates_arg = get_cmd_option(argv, argv + argc, "--speculative_gates"); !
+        speculative_gates_arg.empty()) {
+        config.speculative_gates = std::stoi(speculative_gates_arg);
+    }
 
     config.intermediate_steps = 200;
     config.export_step_limit = 2000;
@@ -143,17 +212,226 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    aw2::PointOrder point_order = aw2::FILE_ORDER;
+    if (std::string point_order_arg = get_cmd_option(argv, argv + argc, "--point_order"); !point_order_arg.empty()) {
+        try {
+            point_order = aw2::point_order_from_name(point_order_arg);
+        } catch (const std::invalid_argument &) {
+            std::cerr << "Unknown point order: " << point_order_arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (!batch_arg.empty()) {
+        if (cmd_option_exists(argv, argv + argc, "--input") || cmd_option_exists(argv, argv + argc, "--tiled") ||
+            cmd_option_exists(argv, argv + argc, "--components") ||
+            cmd_option_exists(argv, argv + argc, "--processes")) {
+            std::cerr << "Error: --batch cannot be combined with --input, --tiled, --components or --processes." <<
+                    std::endl;
+            return 1;
+        }
+
+        aw2::BatchConfig batch;
+        batch.point_order = point_order;
+        batch.local_field = cmd_option_exists(argv, argv + argc, "--local_field");
+        if (std::string field_budget_arg = get_cmd_option(argv, argv + argc, "--field_budget"); !field_budget_arg.
+            empty()) {
+            batch.memory_budget = static_cast<std::size_t>(std::stod(field_budget_arg) * (1 << 20));
+        }
+        batch.verify = cmd_option_exists(argv, argv + argc, "--field_verify");
+        batch.n_threads = config.n_threads;
+
+        aw2::batch_wrap_2 bw;
+        bw.statistics_.config.input_file = batch_arg;
+        try {
+            bw.run(aw2::read_manifest(batch_arg), config, batch);
+        } catch (const std::invalid_argument &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+
+        const auto &batch_stats = bw.get_statistics();
+        for (const auto &file: batch_stats.files) {
+            if (!file.ok) std::cerr << "Failed: " << file.input_file << ": " << file.error << std::endl;
+        }
+        std::cout << "Batch wrap: " << batch_stats.n_files << " files (" << batch_stats.n_failed << " failed) on "
+                << batch_stats.config.n_threads << " threads in " << batch_stats.total_time << " ms" << std::endl;
+        std::cout << "Throughput: " << batch_stats.files_per_second << " files/s, " << batch_stats.points_per_second
+                << " points/s, latency p50 " << batch_stats.latency_p50 << " ms, p99 " << batch_stats.latency_p99
+                << " ms" << std::endl;
+        return batch_stats.n_failed > 0 ? 1 : 0;
+    }
+
+    int n_processes = -1;
+    if (std::string processes_arg = get_cmd_option(argv, argv + argc, "--processes"); !processes_arg.empty()) {
+        if (!cmd_option_exists(argv, argv + argc, "--tiled")) {
+            std::cerr << "Error: --processes requires --tiled." << std::endl;
+            return 1;
+        }
+        n_processes = std::stoi(processes_arg);
+        if (n_processes < 0) {
+            std::cerr << "Error: --processes has to be non-negative." << std::endl;
+            return 1;
+        }
+    }
+
+    // preprocessing is timed separately from the algorithm
+    auto &registry = aw2::TimerRegistry::instance();
+    aw2::Timer *preprocessing_timer = registry.create_root_timer("Oracle Preprocessing");
+
+    auto points = aw2::Oracle::read_points(filename);
+    aw2::Timer *reorder_timer = preprocessing_timer->create_child("Point Reordering");
+    preprocessing_timer->start();
+    reorder_timer->start();
+    aw2::reorder_points(points, point_order, static_cast<unsigned>(std::max(0, config.n_threads)));
+    reorder_timer->pause();
+    preprocessing_timer->pause();
+
     aw2::Oracle oracle;
-    oracle.load_points(filename);
+    oracle.add_point_set(points);
+    // the worker processes read the points from a shared mapping instead of a copy of the oracle each
+    std::unique_ptr<aw2::SharedPoints> shared_points;
+    if (n_processes >= 0) {
+        shared_points = std::make_unique<aw2::SharedPoints>(points);
+    }
+    points = aw2::Points();
+
+    aw2::OracleParams oracle_params;
+    oracle_params.alpha = config.alpha * oracle.bbox_diagonal_length();
+    oracle_params.offset = config.offset * oracle.bbox_diagonal_length();
+    if (std::string field_budget_arg = get_cmd_option(argv, argv + argc, "--field_budget"); !field_budget_arg.
+        empty()) {
+        oracle_params.memory_budget = static_cast<std::size_t>(std::stod(field_budget_arg) * (1 << 20));
+    }
+    oracle_params.verify = cmd_option_exists(argv, argv + argc, "--field_verify");
+
+    if (cmd_option_exists(argv, argv + argc, "--tiled") && cmd_option_exists(argv, argv + argc, "--components")) {
+        std::cerr << "Error: --tiled and --components cannot be combined." << std::endl;
+        return 1;
+    }
+
+    if (cmd_option_exists(argv, argv + argc, "--components")) {
+        aw2::component_wrap_2 cw(oracle);
+        cw.statistics_.config.input_file = filename;
+        cw.statistics_.config.point_order = aw2::point_order_name(point_order);
+        try {
+            cw.run(config, oracle_params, cmd_option_exists(argv, argv + argc, "--local_field"));
+        } catch (const std::invalid_argument &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+
+        const auto &component_stats = cw.get_statistics();
+        std::cout << "\n=== TIMING REPORT ===" << std::endl;
+        preprocessing_timer->print_hierarchy();
+        std::cout << "Component wrap: " << component_stats.total_time << " ms, " << component_stats.n_components
+                << " components (" << component_stats.n_enclosed_components << " enclosed) on "
+                << component_stats.config.n_threads << " threads, clustering " << component_stats.clustering_time
+                << " ms" << std::endl;
+        std::cout << "Wrap edges: " << component_stats.n_edges << std::endl;
+        return 0;
+    }
+
+    if (cmd_option_exists(argv, argv + argc, "--tiled")) {
+        aw2::TilingConfig tiling;
+        if (std::string tile_size_arg = get_cmd_option(argv, argv + argc, "--tile_size"); !tile_size_arg.empty()) {
+            tiling.tile_size_factor = std::stod(tile_size_arg);
+        }
+        if (std::string tile_overlap_arg = get_cmd_option(argv, argv + argc, "--tile_overlap"); !tile_overlap_arg.
+            empty()) {
+            tiling.overlap_factor = std::stod(tile_overlap_arg);
+        }
+        tiling.n_threads = config.n_threads;
+        tiling.local_field = cmd_option_exists(argv, argv + argc, "--local_field");
+
+        std::unique_ptr<aw2::sharded_wrap_2> sw;
+        std::unique_ptr<aw2::tiled_wrap_2> tw;
+        if (shared_points) {
+            sw = std::make_unique<aw2::sharded_wrap_2>(oracle, *shared_points);
+        } else {
+            tw = std::make_unique<aw2::tiled_wrap_2>(oracle);
+        }
+        aw2::tiled_wrap_2 &tiled = sw ? sw->tiled_ : *tw;
+        tiled.statistics_.config.input_file = filename;
+        tiled.statistics_.config.point_order = aw2::point_order_name(point_order);
+        try {
+            if (sw) {
+                sw->run(config, tiling, oracle_params, n_processes);
+            } else {
+                tw->run(config, tiling, oracle_params);
+            }
+        } catch (const std::invalid_argument &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        } catch (const std::runtime_error &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+
+        const auto &tiled_stats = tiled.get_statistics();
+        std::cout << "\n=== TIMING REPORT ===" << std::endl;
+        preprocessing_timer->print_hierarchy();
+        std::cout << "Tiled wrap: " << tiled_stats.total_time << " ms, " << tiled_stats.tiles.size() << " of "
+                << tiled_stats.n_tiles_x * tiled_stats.n_tiles_y << " tiles on ";
+        if (sw) {
+            std::cout << tiled_stats.n_processes << " processes";
+        } else {
+            std::cout << tiled_stats.config.n_threads << " threads";
+        }
+        std::cout << ", stitching " << tiled_stats.stitching_time << " ms" << std::endl;
+        std::cout << "Wrap edges: " << tiled_stats.n_edges << " (" << tiled_stats.n_seam_edges << " at seams), "
+                << tiled_stats.n_open_endpoints << " open endpoints" << std::endl;
+        return 0;
+    }
+
+    // the tiled and component drivers only read the points of the whole input and build an oracle per tile or
+    // component
+    aw2::Timer *index_timer = preprocessing_timer->create_child("Spatial Index");
+    preprocessing_timer->start();
+    index_timer->start();
+    oracle.prepare(oracle_params);
+    index_timer->pause();
+    if (cmd_option_exists(argv, argv + argc, "--local_field")) {
+        aw2::Timer *local_field_timer = preprocessing_timer->create_child("Local Geometry Field");
+        local_field_timer->start();
+        oracle.build_local_geometry_field(oracle_params);
+        local_field_timer->pause();
+    }
+    preprocessing_timer->pause();
 
     aw2::alpha_wrap_2 aw(oracle);
 
 
-    // Set input filename in statistics
+    // Set input filename and preprocessing in statistics
     aw.statistics_.config.input_file = filename;
+    aw.statistics_.config.point_order = aw2::point_order_name(point_order);
+    aw.statistics_.timings.point_reordering = reorder_timer->elapsed_ms();
 
-    aw.init(config);
+    try {
+        aw.init(config);
+    } catch (const std::invalid_argument &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
     aw.run();
 
+#ifdef ORACLE_BACKEND_DISTANCE_FIELD
+    const auto field_stats = oracle.field_stats();
+    std::cout << "Distance field: resolution " << field_stats.resolution << ", "
+            << field_stats.n_allocated_tiles << "/" << field_stats.n_tiles << " tiles, "
+            << field_stats.memory_bytes / 1024 << " KiB" << std::endl;
+    if (oracle_params.verify) {
+        std::cout << "Distance field verification: " << field_stats.n_mismatches << " of "
+                << field_stats.n_verified << " queries differ from the exact oracle" << std::endl;
+    }
+#endif
+
+    if (const auto &local_field = oracle.local_geometry_field(); !local_field.empty()) {
+        const auto &local_field_stats = local_field.stats();
+        std::cout << "Local geometry field: resolution " << local_field_stats.resolution << ", "
+                << local_field_stats.n_cells << " cells, " << local_field_stats.memory_bytes / 1024 << " KiB, "
+                << local_field_stats.build_time_ms << " ms" << std::endl;
+    }
+
     return 0;
 }
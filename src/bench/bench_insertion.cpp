@@ -0,0 +1,81 @@
+// Measures the time of a Steiner point like insertion against the size of the triangulation, with and without a
+// locate hint. The inserted points follow a random walk, like consecutive Steiner points along the wrap.
+// Build with -DUSE_DELAUNAY_HIERARCHY=ON to measure the hierarchy instead of the plain triangulation.
+// Usage: alpha_wrap2_bench_insertion [max_vertices] [n_insertions]
+#include "alpha_wrap_2/types.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    aw2::Points uniform_points(const std::size_t n, std::mt19937 &rng) {
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        aw2::Points points;
+        points.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            points.emplace_back(unit(rng), unit(rng));
+        }
+        return points;
+    }
+
+    // random walk inside the unit square with steps of about the average point spacing
+    aw2::Points random_walk(const std::size_t n, const std::size_t n_vertices, std::mt19937 &rng) {
+        std::normal_distribution<double> step(0.0, 1.0 / std::sqrt(static_cast<double>(n_vertices)));
+        aw2::Points points;
+        points.reserve(n);
+        double x = 0.5, y = 0.5;
+        for (std::size_t i = 0; i < n; ++i) {
+            x = std::clamp(x + step(rng), 0.0, 1.0);
+            y = std::clamp(y + step(rng), 0.0, 1.0);
+            points.emplace_back(x, y);
+        }
+        return points;
+    }
+
+    // average time per insertion in microseconds
+    double insert_walk(const aw2::Points &base, const aw2::Points &walk, const bool hinted) {
+        aw2::Delaunay dt;
+        dt.insert(base.begin(), base.end());
+
+        const auto start = std::chrono::steady_clock::now();
+        aw2::Delaunay::Face_handle hint;
+        for (const auto &p: walk) {
+            const auto vh = hinted ? dt.insert(p, hint) : dt.insert(p);
+            hint = vh->face();
+        }
+        const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+        return elapsed.count() / static_cast<double>(walk.size());
+    }
+}
+
+int main(int argc, char **argv) {
+    const std::size_t max_vertices = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    const std::size_t n_insertions = argc > 2 ? std::stoul(argv[2]) : 5000;
+
+    std::cout << "\n=== INSERTION BENCHMARK ===" << std::endl;
+#ifdef USE_DELAUNAY_HIERARCHY
+    std::cout << "Delaunay hierarchy, ";
+#else
+    std::cout << "plain Delaunay triangulation, ";
+#endif
+    std::cout << n_insertions << " insertions per size, us per insertion" << std::endl;
+    std::cout << std::setw(12) << "vertices" << std::setw(12) << "no hint" << std::setw(12) << "hint" << std::endl;
+
+    std::mt19937 rng(42);
+    for (std::size_t n = 1000; n <= max_vertices; n *= 2) {
+        const auto base = uniform_points(n, rng);
+        const auto walk = random_walk(n_insertions, n, rng);
+        const double t_plain = insert_walk(base, walk, false);
+        const double t_hinted = insert_walk(base, walk, true);
+        std::cout << std::setw(12) << n << std::setw(12) << std::fixed << std::setprecision(3) << t_plain
+                << std::setw(12) << t_hinted << std::endl;
+    }
+
+    return 0;
+}
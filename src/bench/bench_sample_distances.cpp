@@ -0,0 +1,106 @@
+// Compares one nearest neighbor query per gate sample against the batched squared_distances of the oracle.
+// Usage: alpha_wrap2_bench_sample_distances [n_points] [n_gates]
+#include "alpha_wrap_2/oracle.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // relative to the bounding box diagonal
+    constexpr double alpha = 0.002;
+    constexpr double offset = 0.002;
+    constexpr double max_gate_length = 0.05;
+
+    aw2::Points noisy_circle(const std::size_t n) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> angle(0.0, 2.0 * M_PI);
+        std::normal_distribution<double> noise(0.0, 0.01);
+
+        aw2::Points points;
+        points.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const double a = angle(rng);
+            const double r = 1.0 + noise(rng);
+            points.emplace_back(r * std::cos(a), r * std::sin(a));
+        }
+        return points;
+    }
+
+    // samples of random gates close to the input, spaced like the intersection based traversability samples them
+    std::vector<std::vector<aw2::Point_2>> gate_samples(const std::size_t n_gates, const double diagonal) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        std::vector<std::vector<aw2::Point_2>> gates(n_gates);
+        for (auto &samples: gates) {
+            const double a = 2.0 * M_PI * unit(rng);
+            const double r = 1.0 + 0.05 * (unit(rng) - 0.5);
+            const double b = 2.0 * M_PI * unit(rng);
+            const double length = max_gate_length * diagonal * unit(rng);
+            const aw2::Point_2 s(r * std::cos(a), r * std::sin(a));
+            const aw2::Point_2 t(s.x() + length * std::cos(b), s.y() + length * std::sin(b));
+            const int m = static_cast<int>(std::ceil(length / (alpha * diagonal)));
+            for (int i = 1; i < m; ++i) {
+                samples.push_back(s + (static_cast<double>(i) / m) * (t - s));
+            }
+        }
+        return gates;
+    }
+}
+
+int main(int argc, char **argv) {
+    const std::size_t n_points = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const std::size_t n_gates = argc > 2 ? std::stoul(argv[2]) : 20000;
+
+    aw2::Oracle oracle;
+    oracle.add_point_set(noisy_circle(n_points));
+
+    aw2::OracleParams oracle_params;
+    oracle_params.alpha = alpha * oracle.bbox_diagonal_length();
+    oracle_params.offset = offset * oracle.bbox_diagonal_length();
+    oracle.prepare(oracle_params);
+
+    const auto gates = gate_samples(n_gates, oracle.bbox_diagonal_length());
+    std::size_t n_samples = 0;
+    for (const auto &samples: gates) n_samples += samples.size();
+
+    std::vector<std::vector<double>> single(gates.size()), batched(gates.size());
+
+    const auto elapsed_ms = [](const auto start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        for (const auto &p: gates[g]) {
+            single[g].push_back(oracle.squared_distance(p));
+        }
+    }
+    const double t_single = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        oracle.squared_distances(gates[g], batched[g]);
+    }
+    const double t_batched = elapsed_ms(start);
+
+    std::size_t n_mismatches = 0;
+    for (std::size_t g = 0; g < gates.size(); ++g) {
+        for (std::size_t i = 0; i < single[g].size(); ++i) {
+            if (single[g][i] != batched[g][i]) ++n_mismatches;
+        }
+    }
+
+    std::cout << "\n=== SAMPLE DISTANCE BENCHMARK ===" << std::endl;
+    std::cout << n_points << " points, " << n_gates << " gates, " << n_samples << " samples" << std::endl;
+    std::cout << "single queries:  " << t_single << " ms" << std::endl;
+    std::cout << "batched queries: " << t_batched << " ms" << std::endl;
+    std::cout << "speedup:         " << t_single / t_batched << "x" << std::endl;
+    std::cout << "mismatches:      " << n_mismatches << std::endl;
+
+    return n_mismatches == 0 ? 0 : 1;
+}
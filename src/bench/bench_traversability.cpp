@@ -0,0 +1,87 @@
+// Compares the statically dispatched traversability policy against the virtual interface on the constant alpha
+// path. Usage: alpha_wrap2_bench_traversability [n_points] [repetitions]
+#include "alpha_wrap_2/alpha_wrap_2.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // relative to the bounding box diagonal
+    constexpr double alpha = 0.01;
+    constexpr double offset = 0.002;
+
+    aw2::Points noisy_circle(const std::size_t n) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> angle(0.0, 2.0 * M_PI);
+        std::normal_distribution<double> noise(0.0, 0.01);
+
+        aw2::Points points;
+        points.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const double a = angle(rng);
+            const double r = 1.0 + noise(rng);
+            points.emplace_back(r * std::cos(a), r * std::sin(a));
+        }
+        return points;
+    }
+
+    // returns the main loop time of the fastest repetition in ms
+    double run(const aw2::Oracle &oracle, const bool dynamic_traversability, const int repetitions,
+               const std::filesystem::path &output_dir, int &n_iterations) {
+        aw2::AlgorithmConfig config;
+        config.alpha = alpha;
+        config.offset = offset;
+        config.traversability_method = aw2::CONSTANT_ALPHA;
+        config.dynamic_traversability = dynamic_traversability;
+        config.max_iterations = 1000000;
+        config.intermediate_steps = 1000000;
+        config.export_step_limit = 0;
+        config.output_directory = output_dir.string();
+
+        double best = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < repetitions; ++i) {
+            aw2::alpha_wrap_2 aw(oracle);
+            aw.init(config);
+            aw.run();
+            best = std::min(best, aw.get_statistics().timings.main_loop);
+            n_iterations = aw.get_statistics().execution_stats.n_iterations;
+        }
+        return best;
+    }
+}
+
+int main(int argc, char **argv) {
+    const std::size_t n_points = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const int repetitions = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    aw2::Oracle oracle;
+    oracle.add_point_set(noisy_circle(n_points));
+
+    aw2::OracleParams oracle_params;
+    oracle_params.alpha = alpha * oracle.bbox_diagonal_length();
+    oracle_params.offset = offset * oracle.bbox_diagonal_length();
+    oracle.prepare(oracle_params);
+
+    const auto output_dir = std::filesystem::temp_directory_path() / "alpha_wrap_2_bench";
+
+    const auto start = std::chrono::steady_clock::now();
+    int n_static = 0, n_dynamic = 0;
+    const double t_static = run(oracle, false, repetitions, output_dir / "static", n_static);
+    const double t_dynamic = run(oracle, true, repetitions, output_dir / "dynamic", n_dynamic);
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "\n=== TRAVERSABILITY DISPATCH BENCHMARK ===" << std::endl;
+    std::cout << n_points << " points, best of " << repetitions << " runs (" << elapsed << " s total)" << std::endl;
+    std::cout << "static policy:     " << t_static << " ms main loop, " << n_static << " iterations" << std::endl;
+    std::cout << "virtual interface: " << t_dynamic << " ms main loop, " << n_dynamic << " iterations" << std::endl;
+    std::cout << "speedup:           " << t_dynamic / t_static << "x" << std::endl;
+
+    return n_static == n_dynamic ? 0 : 1;
+}